@@ -0,0 +1,240 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// 通用基准测试框架（仅头文件）
+// 每个测试先预热若干次，再重复测量，报告中位数 / p95 / 均值 / 标准差 / 最小值与吞吐量（元素/秒）；
+// Linux 下可选用 perf_event_open 读取硬件计数器；结果可导出为 CSV / JSON，便于跨提交比较。
+// 计时只覆盖 body，setup 用于在每次运行前恢复相同的输入（不计时）。
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+struct BenchConfig {
+    int warmup = 2;                 // 预热次数
+    int repeats = 10;               // 计时次数
+    unsigned seed = 20241110;       // 数据生成的固定种子
+    bool counters = false;          // 是否读取硬件计数器
+    std::string csvPath;            // 非空时写出 CSV
+    std::string jsonPath;           // 非空时写出 JSON
+
+    // 解析 --warmup N --repeats N --seed N --counters --csv 文件 --json 文件
+    static BenchConfig fromArgs(int argc, char** argv) {
+        BenchConfig cfg;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--warmup" && hasValue) cfg.warmup = std::atoi(argv[++i]);
+            else if (arg == "--repeats" && hasValue) cfg.repeats = std::max(1, std::atoi(argv[++i]));
+            else if (arg == "--seed" && hasValue) cfg.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--counters") cfg.counters = true;
+            else if (arg == "--csv" && hasValue) cfg.csvPath = argv[++i];
+            else if (arg == "--json" && hasValue) cfg.jsonPath = argv[++i];
+        }
+        return cfg;
+    }
+};
+
+// 硬件计数器（周期、指令、缓存未命中、分支预测失败），打开失败时各项为 -1
+class PerfCounters {
+public:
+    static const int COUNT = 4;
+
+    PerfCounters() { for (int i = 0; i < COUNT; i++) fds[i] = -1; }
+    ~PerfCounters() { close(); }
+
+    bool open() {
+#ifdef __linux__
+        const uint64_t configs[COUNT] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                          PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+        bool any = false;
+        for (int i = 0; i < COUNT; i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+            any = any || fds[i] >= 0;
+        }
+        return any;
+#else
+        return false;
+#endif
+    }
+    void start() {
+#ifdef __linux__
+        for (int i = 0; i < COUNT; i++) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    void stop(int64_t* values) {
+        for (int i = 0; i < COUNT; i++) {
+            values[i] = -1;
+#ifdef __linux__
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t v = 0;
+            if (read(fds[i], &v, sizeof(v)) == sizeof(v)) values[i] = static_cast<int64_t>(v);
+#endif
+        }
+    }
+    void close() {
+#ifdef __linux__
+        for (int i = 0; i < COUNT; i++) {
+            if (fds[i] >= 0) ::close(fds[i]);
+            fds[i] = -1;
+        }
+#endif
+    }
+
+private:
+    int fds[COUNT];
+};
+
+struct BenchResult {
+    std::string name;               // 算法名
+    std::string params;             // 数据分布等参数
+    size_t elements = 0;            // 每次运行处理的元素数
+    std::vector<double> samples;    // 每次运行耗时（秒）
+    double median = 0, p95 = 0, mean = 0, stddev = 0, min = 0;
+    double throughput = 0;          // 元素/秒（按中位数计算）
+    int64_t counters[PerfCounters::COUNT] = { -1, -1, -1, -1 };  // 每次运行的平均值
+
+    void summarize() {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        median = (n % 2) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+        p95 = sorted[std::min(n - 1, static_cast<size_t>(std::ceil(0.95 * n)) - 1)];
+        min = sorted[0];
+        mean = 0;
+        for (double s : sorted) mean += s;
+        mean /= n;
+        double var = 0;
+        for (double s : sorted) var += (s - mean) * (s - mean);
+        stddev = n > 1 ? std::sqrt(var / (n - 1)) : 0;
+        throughput = median > 0 ? elements / median : 0;
+    }
+};
+
+class Benchmark {
+public:
+    explicit Benchmark(const BenchConfig& config) : cfg(config) {
+        if (cfg.counters && !perf.open()) {
+            std::cerr << "warning: perf_event_open unavailable, hardware counters disabled" << std::endl;
+            cfg.counters = false;
+        }
+    }
+    ~Benchmark() { flush(); }
+
+    const BenchConfig& config() const { return cfg; }
+    const std::vector<BenchResult>& results() const { return all; }
+
+    // 运行一项测试：每次运行前调用 setup()（不计时），然后计时 body()
+    const BenchResult& run(const std::string& name, const std::string& params, size_t elements,
+                           const std::function<void()>& setup, const std::function<void()>& body) {
+        BenchResult r;
+        r.name = name;
+        r.params = params;
+        r.elements = elements;
+        for (int i = 0; i < cfg.warmup; i++) { setup(); body(); }
+        int64_t sums[PerfCounters::COUNT] = {};
+        for (int i = 0; i < cfg.repeats; i++) {
+            setup();
+            if (cfg.counters) perf.start();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            if (cfg.counters) {
+                int64_t values[PerfCounters::COUNT];
+                perf.stop(values);
+                for (int k = 0; k < PerfCounters::COUNT; k++) sums[k] += values[k];
+            }
+            r.samples.push_back(std::chrono::duration<double>(end - start).count());
+        }
+        if (cfg.counters) {
+            for (int k = 0; k < PerfCounters::COUNT; k++) r.counters[k] = sums[k] / cfg.repeats;
+        }
+        r.summarize();
+        print(std::cout, r);
+        all.push_back(r);
+        return all.back();
+    }
+
+    static void print(std::ostream& os, const BenchResult& r) {
+        os << r.name << " on " << r.params << " with " << r.elements << " elements: median "
+           << r.median << " s, p95 " << r.p95 << " s, stddev " << r.stddev << " s, "
+           << r.throughput << " elements/s";
+        if (r.counters[0] >= 0) os << ", " << r.counters[0] << " cycles";
+        if (r.counters[1] >= 0) os << ", " << r.counters[1] << " instructions";
+        os << std::endl;
+    }
+
+    void writeCsv(std::ostream& os) const {
+        os << "name,params,elements,repeats,median_s,p95_s,mean_s,stddev_s,min_s,throughput_eps,"
+              "cycles,instructions,cache_misses,branch_misses\n";
+        for (const auto& r : all) {
+            os << '"' << r.name << "\",\"" << r.params << "\"," << r.elements << ',' << r.samples.size() << ','
+               << r.median << ',' << r.p95 << ',' << r.mean << ',' << r.stddev << ',' << r.min << ','
+               << r.throughput;
+            for (int k = 0; k < PerfCounters::COUNT; k++) os << ',' << r.counters[k];
+            os << '\n';
+        }
+    }
+
+    void writeJson(std::ostream& os) const {
+        const char* counterNames[PerfCounters::COUNT] = { "cycles", "instructions", "cache_misses", "branch_misses" };
+        os << "[\n";
+        for (size_t i = 0; i < all.size(); i++) {
+            const auto& r = all[i];
+            os << "  {\"name\": \"" << r.name << "\", \"params\": \"" << r.params << "\", \"elements\": " << r.elements
+               << ", \"repeats\": " << r.samples.size() << ", \"median_s\": " << r.median << ", \"p95_s\": " << r.p95
+               << ", \"mean_s\": " << r.mean << ", \"stddev_s\": " << r.stddev << ", \"min_s\": " << r.min
+               << ", \"throughput_eps\": " << r.throughput;
+            for (int k = 0; k < PerfCounters::COUNT; k++) os << ", \"" << counterNames[k] << "\": " << r.counters[k];
+            os << "}" << (i + 1 < all.size() ? "," : "") << "\n";
+        }
+        os << "]\n";
+    }
+
+    // 按配置写出 CSV / JSON 文件（析构时自动调用）
+    void flush() {
+        if (!cfg.csvPath.empty()) {
+            std::ofstream out(cfg.csvPath);
+            writeCsv(out);
+        }
+        if (!cfg.jsonPath.empty()) {
+            std::ofstream out(cfg.jsonPath);
+            writeJson(out);
+        }
+    }
+
+private:
+    BenchConfig cfg;
+    PerfCounters perf;
+    std::vector<BenchResult> all;
+};
+
+#endif // BENCHMARK_H
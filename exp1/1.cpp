@@ -176,13 +176,13 @@ int main() {
     clock_t start = clock(); // 记录开始时间
     bubbleSort(vecCopy); // 冒泡排序
     clock_t end = clock(); // 记录结束时间
-    std::cout << "冒泡排序时间: " << (end - start) / CLOCKS_PER_SEC << " 秒" << std::endl;
+    std::cout << "冒泡排序时间: " << static_cast<double>(end - start) / CLOCKS_PER_SEC << " 秒" << std::endl;
 
     vecCopy = vec;
     start = clock(); // 记录开始时间
     mergeSort(vecCopy); // 归并排序
     end = clock(); // 记录结束时间
-    std::cout << "归并排序时间: " << (end - start) / CLOCKS_PER_SEC << " 秒" << std::endl;
+    std::cout << "归并排序时间: " << static_cast<double>(end - start) / CLOCKS_PER_SEC << " 秒" << std::endl;
 
     // 测试区间查找
     double m1 = 2.0, m2 = 5.0;
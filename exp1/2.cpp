@@ -2,7 +2,27 @@
 #include <vector>
 #include <string>
 #include <cctype>
+#include <cstdint>
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
 #include <stdexcept>
+#include <string_view>
+#include <charconv>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include "../Benchmark.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define EXPR_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // 栈的实现
 class Stack {
@@ -140,13 +160,743 @@ int evaluate(const std::string& expression) {
     throw std::invalid_argument("无效的表达式");
 }
 
-int main() {
+// 编译后的表达式：一次解析为后缀字节码（调度场算法，常量折叠），之后可用不同的变量取值反复求值。
+// 支持 + - * /、括号、一元负号、整数常量与变量名（字母或下划线开头），求值时按变量编号绑定取值。
+class Expression {
+public:
+    enum OpCode : uint8_t { CONST, VAR, ADD, SUB, MUL, DIV, NEG };
+    struct Instr {
+        OpCode op;
+        int arg;                                // CONST 为常量值，VAR 为变量编号
+    };
+    static const int MAX_STACK = 64;            // 求值栈容量，编译时检查
+
+    std::vector<Instr> code;
+    std::vector<std::string> variables;         // 变量名，按首次出现的顺序编号
+    int maxDepth = 0;                           // 求值时栈的最大深度
+
+    static Expression compile(const std::string& expression) {
+        Expression e;
+        std::vector<char> ops;                  // 运算符栈，'~' 表示一元负号
+        int depth = 0;
+        bool expectOperand = true;              // 下一个记号应为操作数（或一元运算符、左括号）
+        auto reduce = [&]() {
+            char op = ops.back();
+            ops.pop_back();
+            e.emit(op, depth);
+        };
+        for (size_t i = 0; i < expression.length(); ++i) {
+            char c = expression[i];
+            if (c == ' ') continue;
+            if (is_number(c) || std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                if (!expectOperand) throw std::invalid_argument("缺少运算符");
+                if (is_number(c)) {
+                    long long val = 0;
+                    for (; i < expression.length() && is_number(expression[i]); ++i) {
+                        val = val * 10 + (expression[i] - '0');
+                        if (val > INT_MAX) throw std::invalid_argument("常量超出范围");
+                    }
+                    e.code.push_back({ CONST, static_cast<int>(val) });
+                } else {
+                    size_t start = i;
+                    while (i < expression.length() && (std::isalnum(static_cast<unsigned char>(expression[i])) || expression[i] == '_')) ++i;
+                    e.code.push_back({ VAR, e.variableSlot(expression.substr(start, i - start)) });
+                }
+                --i;
+                e.maxDepth = std::max(e.maxDepth, ++depth);
+                expectOperand = false;
+            }
+            else if (c == '(') {
+                if (!expectOperand) throw std::invalid_argument("缺少运算符");
+                ops.push_back(c);
+            }
+            else if (c == ')') {
+                if (expectOperand) throw std::invalid_argument("缺少操作数");
+                while (!ops.empty() && ops.back() != '(') reduce();
+                if (ops.empty()) throw std::invalid_argument("括号不匹配");
+                ops.pop_back();
+            }
+            else if (is_operator(c)) {
+                if (expectOperand) {            // 一元运算符：负号入栈，正号忽略
+                    if (c == '-') ops.push_back('~');
+                    else if (c != '+') throw std::invalid_argument("缺少操作数");
+                    continue;
+                }
+                while (!ops.empty() && ops.back() != '(' && unaryOrPrecedence(ops.back()) >= precedence(c)) reduce();
+                ops.push_back(c);
+                expectOperand = true;
+            }
+            else {
+                throw std::invalid_argument("无效的字符");
+            }
+            if (e.maxDepth > MAX_STACK) throw std::invalid_argument("表达式嵌套过深");
+        }
+        if (expectOperand) throw std::invalid_argument(e.code.empty() ? "无效的表达式" : "缺少操作数");
+        while (!ops.empty()) {
+            if (ops.back() == '(') throw std::invalid_argument("括号不匹配");
+            reduce();
+        }
+        return e;
+    }
+
+    int variableIndex(const std::string& name) const {   // 不存在返回 -1
+        for (size_t k = 0; k < variables.size(); k++) if (variables[k] == name) return static_cast<int>(k);
+        return -1;
+    }
+
+    // 求值：vars[k] 为第 k 个变量的取值。字节码已在编译时校验，循环内不做栈检查；
+    // 除零与 int 溢出（含 INT_MIN / -1、-INT_MIN）抛出 invalid_argument
+    int evaluate(const int* vars = nullptr) const {
+        int stack[MAX_STACK];
+        int sp = -1;
+        bool overflow = false;
+        for (const Instr& in : code) {
+            switch (in.op) {
+            case CONST: stack[++sp] = in.arg; break;
+            case VAR: stack[++sp] = vars[in.arg]; break;
+            case ADD: overflow |= __builtin_add_overflow(stack[sp - 1], stack[sp], &stack[sp - 1]); --sp; break;
+            case SUB: overflow |= __builtin_sub_overflow(stack[sp - 1], stack[sp], &stack[sp - 1]); --sp; break;
+            case MUL: overflow |= __builtin_mul_overflow(stack[sp - 1], stack[sp], &stack[sp - 1]); --sp; break;
+            case DIV:
+                if (stack[sp] == 0) throw std::invalid_argument("除数不能为零");
+                if (stack[sp] == -1 && stack[sp - 1] == INT_MIN) throw std::invalid_argument("整数溢出");
+                stack[sp - 1] /= stack[sp]; --sp;
+                break;
+            case NEG:
+                if (stack[sp] == INT_MIN) throw std::invalid_argument("整数溢出");
+                stack[sp] = -stack[sp];
+                break;
+            }
+            if (overflow) throw std::invalid_argument("整数溢出");
+        }
+        return stack[0];
+    }
+    int evaluate(const std::vector<int>& vars) const {
+        if (vars.size() < variables.size()) throw std::invalid_argument("变量取值不足");
+        return evaluate(vars.data());
+    }
+
+    // 按 double 逐行求值，与 evaluateBatch<double> 的语义一致：除零时 result 为 0 并返回 false
+    bool evaluate(const double* vars, double& result) const {
+        double stack[MAX_STACK];
+        int sp = -1;
+        bool ok = true;
+        for (const Instr& in : code) {
+            switch (in.op) {
+            case CONST: stack[++sp] = in.arg; break;
+            case VAR: stack[++sp] = vars[in.arg]; break;
+            case ADD: stack[sp - 1] += stack[sp]; --sp; break;
+            case SUB: stack[sp - 1] -= stack[sp]; --sp; break;
+            case MUL: stack[sp - 1] *= stack[sp]; --sp; break;
+            case DIV:
+                if (stack[sp] == 0) ok = false, stack[sp - 1] = 0;
+                else stack[sp - 1] /= stack[sp];
+                --sp;
+                break;
+            case NEG: stack[sp] = -stack[sp]; break;
+            }
+        }
+        result = ok ? stack[0] : 0;            // 出错子式已置 0 但求值继续，整行结果须另行清零
+        return ok;
+    }
+
+    static const size_t BATCH_BLOCK = 1024;     // 列式求值的块长
+
+    // 列式批量求值：columns[k] 为第 k 个变量的取值列，结果写入 out[0, rows)。
+    // 每块 BATCH_BLOCK 行逐条指令整块计算（内层循环无分支，可自动向量化）；T 取 int64_t 或 double 选择运算方式。
+    // 除零（以及 int64 的 INT64_MIN / -1）不抛异常：该行结果为 0，并在 errors 位图中置位
+    // （errors 至少 (rows + 63) / 64 个字），返回出错行数
+    template <typename T>
+    size_t evaluateBatch(const T* const* columns, size_t rows, T* out, uint64_t* errors) const {
+        static_assert(std::is_same<T, int64_t>::value || std::is_same<T, double>::value, "int64_t or double");
+        const size_t B = BATCH_BLOCK;
+        size_t consts = 0;
+        for (const Instr& in : code) consts += in.op == CONST;
+        std::vector<T> levels(static_cast<size_t>(maxDepth) * B), constants(consts * B);
+        for (size_t k = 0, c = 0; k < code.size(); k++) {      // 常量块只需填充一次
+            if (code[k].op == CONST) std::fill_n(&constants[B * c++], B, static_cast<T>(code[k].arg));
+        }
+        uint8_t err[BATCH_BLOCK];
+        size_t failed = 0;
+        for (size_t base = 0; base < rows; base += B) {
+            size_t m = std::min(B, rows - base);
+            const T* stack[MAX_STACK];
+            int sp = -1;
+            size_t c = 0;
+            memset(err, 0, m);
+            for (const Instr& in : code) {
+                if (in.op == CONST) { stack[++sp] = &constants[B * c++]; continue; }
+                if (in.op == VAR) { stack[++sp] = columns[in.arg] + base; continue; }
+                if (in.op == NEG) {
+                    T* r = &levels[B * sp];
+                    negateBlock(stack[sp], r, m);
+                    stack[sp] = r;
+                    continue;
+                }
+                T* r = &levels[B * (sp - 1)];   // 结果写入该栈层的缓冲，可与左操作数相同
+                const T* a = stack[sp - 1];
+                const T* b = stack[sp];
+                switch (in.op) {
+                case ADD: for (size_t i = 0; i < m; i++) r[i] = add(a[i], b[i]); break;
+                case SUB: for (size_t i = 0; i < m; i++) r[i] = sub(a[i], b[i]); break;
+                case MUL: for (size_t i = 0; i < m; i++) r[i] = mul(a[i], b[i]); break;
+                default: divideBlock(a, b, r, err, m); break;
+                }
+                stack[--sp] = r;
+            }
+            for (size_t i = 0; i < m; i++) out[base + i] = err[i] ? 0 : stack[0][i];   // 出错行整行置 0
+            for (size_t w = 0; w < (m + 63) / 64; w++) {  // 块起点是 64 的倍数，按字打包错误标记
+                uint64_t bits = 0;
+                for (size_t i = 0; i < 64 && 64 * w + i < m; i++) bits |= uint64_t(err[64 * w + i]) << i;
+                errors[base / 64 + w] = bits;
+                failed += __builtin_popcountll(bits);
+            }
+        }
+        return failed;
+    }
+
+private:
+    // 整数按无符号运算，溢出时回绕而不是未定义行为
+    static int64_t add(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b)); }
+    static int64_t sub(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b)); }
+    static int64_t mul(int64_t a, int64_t b) { return static_cast<int64_t>(static_cast<uint64_t>(a) * static_cast<uint64_t>(b)); }
+    static double add(double a, double b) { return a + b; }
+    static double sub(double a, double b) { return a - b; }
+    static double mul(double a, double b) { return a * b; }
+
+    static void negateBlock(const int64_t* a, int64_t* r, size_t m) {
+        for (size_t i = 0; i < m; i++) r[i] = static_cast<int64_t>(0 - static_cast<uint64_t>(a[i]));
+    }
+    static void negateBlock(const double* a, double* r, size_t m) {
+        for (size_t i = 0; i < m; i++) r[i] = -a[i];
+    }
+    static void divideBlock(const int64_t* a, const int64_t* b, int64_t* r, uint8_t* err, size_t m) {
+        for (size_t i = 0; i < m; i++) {
+            bool bad = b[i] == 0 || (b[i] == -1 && a[i] == INT64_MIN);
+            int64_t d = bad ? 1 : b[i];
+            err[i] |= bad;
+            r[i] = bad ? 0 : a[i] / d;
+        }
+    }
+    static void divideBlock(const double* a, const double* b, double* r, uint8_t* err, size_t m) {
+        for (size_t i = 0; i < m; i++) {
+            bool bad = b[i] == 0;
+            err[i] |= bad;
+            r[i] = bad ? 0 : a[i] / b[i];
+        }
+    }
+
+    static int unaryOrPrecedence(char op) { return op == '~' ? 3 : precedence(op); }
+
+    int variableSlot(const std::string& name) {
+        int k = variableIndex(name);
+        if (k >= 0) return k;
+        variables.push_back(name);
+        return static_cast<int>(variables.size()) - 1;
+    }
+
+    // 生成一条运算指令；操作数都是常量时就地折叠加、减、乘与负号。除法不折叠：同一份字节码
+    // 也用于 evaluateBatch<double>，整数除法折叠会让 double 求值结果与变量写法不一致
+    void emit(char op, int& depth) {
+        if (op == '~') {
+            if (code.back().op == CONST && code.back().arg != INT_MIN) code.back().arg = -code.back().arg;
+            else code.push_back({ NEG, 0 });
+            return;
+        }
+        --depth;
+        size_t n = code.size();
+        if (op != '/' && code[n - 1].op == CONST && code[n - 2].op == CONST) {
+            long long a = code[n - 2].arg, b = code[n - 1].arg;
+            long long r = op == '+' ? a + b : op == '-' ? a - b : a * b;
+            if (r >= INT_MIN && r <= INT_MAX) {
+                code.pop_back();
+                code.back().arg = static_cast<int>(r);
+                return;
+            }
+        }
+        OpCode oc = op == '+' ? ADD : op == '-' ? SUB : op == '*' ? MUL : DIV;
+        code.push_back({ oc, 0 });
+    }
+};
+
+// ---------------- 批量文件求值 ----------------
+// 每行一个常量表达式，按 64 位整数求值；解析直接作用于 std::string_view，出错以状态码返回，不抛异常
+
+// 定长栈：容量固定、不分配内存，溢出或取空时返回 false
+template <typename T, int N>
+class FixedStack {
+private:
+    T items[N];
+    int n = 0;
+
+public:
+    bool is_empty() const { return n == 0; }
+    bool push(T item) {
+        if (n == N) return false;
+        items[n++] = item;
+        return true;
+    }
+    bool pop(T& item) {
+        if (n == 0) return false;
+        item = items[--n];
+        return true;
+    }
+    bool top(T& item) const {
+        if (n == 0) return false;
+        item = items[n - 1];
+        return true;
+    }
+};
+
+enum EvalStatus { EVAL_OK, EVAL_DIV_ZERO, EVAL_SYNTAX, EVAL_TOO_DEEP };
+
+const char* evalMessage(EvalStatus status) {
+    switch (status) {
+    case EVAL_OK: return "";
+    case EVAL_DIV_ZERO: return "除数不能为零";
+    case EVAL_TOO_DEEP: return "表达式嵌套过深";
+    default: return "无效的表达式";
+    }
+}
+
+// 单遍求值一行表达式（调度场算法，边扫描边计算），整数运算溢出时回绕
+EvalStatus evaluateLine(std::string_view s, int64_t& result) {
+    FixedStack<int64_t, 64> values;
+    FixedStack<char, 64> ops;                   // '~' 表示一元负号
+    bool expectOperand = true;
+    auto reduce = [&]() -> EvalStatus {
+        char op;
+        int64_t a, b;
+        if (!ops.pop(op)) return EVAL_SYNTAX;
+        if (op == '~') {
+            if (!values.pop(a)) return EVAL_SYNTAX;
+            values.push(static_cast<int64_t>(0 - static_cast<uint64_t>(a)));
+            return EVAL_OK;
+        }
+        if (!values.pop(b) || !values.pop(a)) return EVAL_SYNTAX;
+        uint64_t ua = static_cast<uint64_t>(a), ub = static_cast<uint64_t>(b);
+        switch (op) {
+        case '+': values.push(static_cast<int64_t>(ua + ub)); break;
+        case '-': values.push(static_cast<int64_t>(ua - ub)); break;
+        case '*': values.push(static_cast<int64_t>(ua * ub)); break;
+        default:
+            if (b == 0 || (b == -1 && a == INT64_MIN)) return EVAL_DIV_ZERO;
+            values.push(a / b);
+            break;
+        }
+        return EVAL_OK;
+    };
+    auto prec = [](char op) { return op == '~' ? 3 : precedence(op); };
+    for (size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (c == ' ' || c == '\t' || c == '\r') continue;
+        EvalStatus st = EVAL_OK;
+        if (is_number(c)) {
+            if (!expectOperand) return EVAL_SYNTAX;
+            uint64_t val = 0;
+            for (; i < s.size() && is_number(s[i]); ++i) {
+                uint64_t d = static_cast<uint64_t>(s[i] - '0');
+                if (val > (static_cast<uint64_t>(INT64_MAX) - d) / 10) return EVAL_SYNTAX;   // 先判断再乘，避免回绕
+                val = val * 10 + d;
+            }
+            --i;
+            if (!values.push(static_cast<int64_t>(val))) return EVAL_TOO_DEEP;
+            expectOperand = false;
+        }
+        else if (c == '(') {
+            if (!expectOperand) return EVAL_SYNTAX;
+            if (!ops.push(c)) return EVAL_TOO_DEEP;
+        }
+        else if (c == ')') {
+            char op;
+            if (expectOperand) return EVAL_SYNTAX;
+            while (ops.top(op) && op != '(' && (st = reduce()) == EVAL_OK) {}
+            if (st != EVAL_OK) return st;
+            if (!ops.pop(op)) return EVAL_SYNTAX;
+        }
+        else if (is_operator(c)) {
+            char op;
+            if (expectOperand) {                // 一元运算符：负号入栈，正号忽略
+                if (c == '-' && !ops.push('~')) return EVAL_TOO_DEEP;
+                if (c != '-' && c != '+') return EVAL_SYNTAX;
+                continue;
+            }
+            while (ops.top(op) && op != '(' && prec(op) >= precedence(c) && (st = reduce()) == EVAL_OK) {}
+            if (st != EVAL_OK) return st;
+            if (!ops.push(c)) return EVAL_TOO_DEEP;
+            expectOperand = true;
+        }
+        else {
+            return EVAL_SYNTAX;
+        }
+    }
+    if (expectOperand) return EVAL_SYNTAX;
+    char op;
+    while (ops.top(op)) {
+        if (op == '(') return EVAL_SYNTAX;
+        EvalStatus st = reduce();
+        if (st != EVAL_OK) return st;
+    }
+    return values.pop(result) && values.is_empty() ? EVAL_OK : EVAL_SYNTAX;
+}
+
+// 带缓冲的输出：攒满 1 MB 再整块 fwrite
+class BufferedWriter {
+private:
+    FILE* fp;
+    std::vector<char> buf;
+    size_t n = 0;
+
+public:
+    explicit BufferedWriter(FILE* f, size_t capacity = 1 << 20) : fp(f), buf(capacity) {}
+    ~BufferedWriter() { flush(); }
+    void write(const char* p, size_t len) {
+        if (n + len > buf.size()) {
+            flush();
+            if (len > buf.size()) { fwrite(p, 1, len, fp); return; }
+        }
+        memcpy(&buf[n], p, len);
+        n += len;
+    }
+    void flush() {
+        if (n) fwrite(buf.data(), 1, n, fp);
+        n = 0;
+    }
+};
+
+// 批量求值：把输入按行边界切成约 CHUNK 字节的块，工作线程并行求值，每块结果写入各自的缓冲，
+// 主线程按块序输出；每轮处理 threads × 4 块，内存占用与输入大小无关。返回处理的行数
+class BulkEvaluator {
+public:
+    static const size_t CHUNK = 1 << 20;
+
+    explicit BulkEvaluator(unsigned threads = 0) : threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    // data 须以完整的行结束（或为输入末尾）
+    size_t process(const char* data, size_t size, BufferedWriter& out) {
+        std::vector<std::string_view> chunks;
+        for (size_t pos = 0; pos < size;) {
+            size_t end = std::min(size, pos + CHUNK);
+            const void* nl = end < size ? memchr(data + end, '\n', size - end) : nullptr;
+            end = nl ? static_cast<const char*>(nl) - data + 1 : size;
+            chunks.push_back(std::string_view(data + pos, end - pos));
+            pos = end;
+        }
+        size_t lines = 0, window = threads * 4;
+        std::vector<std::string> results(window);
+        std::vector<size_t> counts(window);
+        for (size_t base = 0; base < chunks.size(); base += window) {
+            size_t m = std::min(window, chunks.size() - base);
+            std::atomic<size_t> next(0);
+            auto work = [&] {
+                for (size_t k; (k = next.fetch_add(1)) < m;) counts[k] = evaluateChunk(chunks[base + k], results[k]);
+            };
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < std::min<size_t>(threads, m); t++) pool.emplace_back(work);
+            work();
+            for (auto& th : pool) th.join();
+            for (size_t k = 0; k < m; k++) {
+                out.write(results[k].data(), results[k].size());
+                lines += counts[k];
+            }
+        }
+        return lines;
+    }
+
+    // 处理整个文件：支持 mmap 时映射整个文件，否则按 16 MB 大块读入，残行留到下一块
+    size_t processFile(const char* path, BufferedWriter& out) {
+#ifdef EXPR_HAS_MMAP
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) throw std::runtime_error(std::string("无法打开文件 ") + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0) { close(fd); throw std::runtime_error(std::string("无法读取文件 ") + path); }
+        size_t size = static_cast<size_t>(st.st_size);
+        if (size == 0) { close(fd); return 0; }
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error(std::string("无法映射文件 ") + path);
+        madvise(p, size, MADV_SEQUENTIAL);
+        size_t lines = process(static_cast<const char*>(p), size, out);
+        munmap(p, size);
+        return lines;
+#else
+        FILE* fp = fopen(path, "rb");
+        if (!fp) throw std::runtime_error(std::string("无法打开文件 ") + path);
+        const size_t BLOCK = size_t(1) << 24;
+        std::vector<char> buf(BLOCK);
+        size_t have = 0, lines = 0;
+        for (;;) {
+            if (have == buf.size()) buf.resize(buf.size() * 2);  // 单行超过块长
+            size_t got = fread(&buf[have], 1, buf.size() - have, fp);
+            have += got;
+            if (got == 0) break;
+            size_t end = have;
+            while (end > 0 && buf[end - 1] != '\n') end--;
+            if (end == 0) continue;
+            lines += process(buf.data(), end, out);
+            memmove(buf.data(), buf.data() + end, have - end);
+            have -= end;
+        }
+        fclose(fp);
+        if (have) lines += process(buf.data(), have, out);
+        return lines;
+#endif
+    }
+
+private:
+    unsigned threads;
+
+    // 逐行求值一块，结果（或错误信息）每行一条写入 out，返回行数
+    static size_t evaluateChunk(std::string_view chunk, std::string& out) {
+        out.clear();
+        out.reserve(chunk.size());
+        size_t lines = 0;
+        char num[24];
+        while (!chunk.empty()) {
+            size_t nl = chunk.find('\n');
+            std::string_view line = chunk.substr(0, nl);
+            chunk.remove_prefix(nl == std::string_view::npos ? chunk.size() : nl + 1);
+            int64_t value;
+            EvalStatus st = evaluateLine(line, value);
+            if (st == EVAL_OK) {
+                char* end = std::to_chars(num, num + sizeof(num), value).ptr;
+                out.append(num, end);
+            } else {
+                out.append("错误: ").append(evalMessage(st));
+            }
+            out.push_back('\n');
+            lines++;
+        }
+        return lines;
+    }
+};
+
+// 基准测试：同一公式、不同变量取值反复求值，对比每次重新解析与编译一次后求值
+void benchmarkEvaluation(Benchmark& bench) {
+    const int N = 100000;
+    const std::string formula = "(a + 3 * b - c / 7) * (2 + 3 * 4) - (a - b) * (c + 12 / 4)";
+    std::vector<int> a(N), b(N), c(N);
+    srand(bench.config().seed);
+    for (int i = 0; i < N; i++) { a[i] = rand() % 1000; b[i] = rand() % 1000; c[i] = rand() % 1000 + 1; }
+
+    std::vector<std::string> texts(N);          // 重新解析：每行把变量代入公式文本
+    for (int i = 0; i < N; i++) {
+        texts[i] = "(" + std::to_string(a[i]) + " + 3 * " + std::to_string(b[i]) + " - " + std::to_string(c[i])
+                 + " / 7) * (2 + 3 * 4) - (" + std::to_string(a[i]) + " - " + std::to_string(b[i]) + ") * ("
+                 + std::to_string(c[i]) + " + 12 / 4)";
+    }
+    long long check1 = 0, check2 = 0;
+    bench.run("Re-parse evaluate", "per row", N, [&] { check1 = 0; },
+              [&] { for (int i = 0; i < N; i++) check1 += evaluate(texts[i]); });
+
+    Expression expr = Expression::compile(formula);
+    int ia = expr.variableIndex("a"), ib = expr.variableIndex("b"), ic = expr.variableIndex("c");
+    const BenchResult& r = bench.run("Compiled evaluate", "per row", N, [&] { check2 = 0; }, [&] {
+        int vars[3];
+        for (int i = 0; i < N; i++) {
+            vars[ia] = a[i]; vars[ib] = b[i]; vars[ic] = c[i];
+            check2 += expr.evaluate(vars);
+        }
+    });
+    int ops = 0;
+    for (const auto& in : expr.code) ops += in.op != Expression::CONST && in.op != Expression::VAR;
+    std::cout << "Compiled to " << expr.code.size() << " instructions (" << ops << " operators), "
+              << 1e9 / r.throughput / std::max(ops, 1) << " ns per operator, results "
+              << (check1 == check2 ? "match" : "DIFFER") << std::endl;
+}
+
+// 基准测试：百万行打分，逐行求值（除零时捕获异常）对比 int64 / double 列式批量求值
+void benchmarkBatch(Benchmark& bench) {
+    const size_t N = 1 << 20;
+    Expression expr = Expression::compile("(a + 3 * b - c / 7) * (2 + 3 * 4) - (a - b) * (c + 12 / 4) + a / (b - 500)");
+    std::vector<int> cols[3];
+    srand(bench.config().seed + 1);
+    for (auto& col : cols) {
+        col.resize(N);
+        for (auto& v : col) v = rand() % 1000 + 1;
+    }
+    int slot[3];
+    for (int k = 0; k < 3; k++) slot[k] = expr.variableIndex(std::string(1, static_cast<char>('a' + k)));
+
+    std::vector<int> rowOut(N);
+    std::vector<uint8_t> rowErr(N);
+    bench.run("Row-at-a-time evaluate", "int", N, [] {}, [&] {
+        int vars[3];
+        for (size_t i = 0; i < N; i++) {
+            for (int k = 0; k < 3; k++) vars[slot[k]] = cols[k][i];
+            try { rowOut[i] = expr.evaluate(vars); rowErr[i] = 0; }
+            catch (const std::invalid_argument&) { rowOut[i] = 0; rowErr[i] = 1; }
+        }
+    });
+
+    std::vector<int64_t> i64[3];
+    std::vector<double> f64[3];
+    const int64_t* i64Cols[3];
+    const double* f64Cols[3];
+    for (int k = 0; k < 3; k++) {
+        i64[k].assign(cols[k].begin(), cols[k].end());
+        f64[k].assign(cols[k].begin(), cols[k].end());
+        i64Cols[slot[k]] = i64[k].data();
+        f64Cols[slot[k]] = f64[k].data();
+    }
+    std::vector<int64_t> i64Out(N);
+    std::vector<double> f64Out(N);
+    std::vector<uint64_t> errors((N + 63) / 64);
+    size_t failed = 0;
+    bench.run("Batch evaluate", "int64", N, [] {}, [&] { failed = expr.evaluateBatch(i64Cols, N, i64Out.data(), errors.data()); });
+    size_t mismatches = 0;
+    for (size_t i = 0; i < N; i++) {
+        bool err = errors[i / 64] >> (i % 64) & 1;
+        mismatches += err != static_cast<bool>(rowErr[i]) || i64Out[i] != rowOut[i];   // 出错行两边都应为 0
+    }
+    bench.run("Batch evaluate", "double", N, [] {}, [&] { expr.evaluateBatch(f64Cols, N, f64Out.data(), errors.data()); });
+    std::cout << failed << " rows divided by zero, int64 batch vs row-at-a-time mismatches: " << mismatches << std::endl;
+
+    // double 批量与逐行 double 求值逐位一致；含常量除法的表达式不能按整数折叠
+    const char* doubleCases[] = { "(a + 3 * b - c / 7) * (2 + 3 * 4) - (a - b) * (c + 12 / 4) + a / (b - 500)",
+                                  "7 / 2 * a", "a / 2 + 9 / 4 - -(5 / 2) * b", "c / (3 - 3) + 1" };
+    size_t doubleMismatches = 0;
+    const size_t M = 4096;
+    std::vector<double> batchOut(M);
+    std::vector<uint64_t> batchErr(M / 64);
+    for (const char* text : doubleCases) {
+        Expression e = Expression::compile(text);
+        const double* columns[3];
+        for (int k = 0; k < 3; k++) {
+            int s = e.variableIndex(std::string(1, static_cast<char>('a' + k)));
+            if (s >= 0) columns[s] = f64[k].data();
+        }
+        e.evaluateBatch(columns, M, batchOut.data(), batchErr.data());
+        for (size_t i = 0; i < M; i++) {
+            double vars[3], v;
+            for (size_t k = 0; k < e.variables.size(); k++) vars[k] = columns[k][i];
+            bool ok = e.evaluate(vars, v);
+            doubleMismatches += ok == static_cast<bool>(batchErr[i / 64] >> (i % 64) & 1) || v != batchOut[i] || (!ok && v != 0);
+        }
+    }
+    // 常量写法与变量写法结果相同：7 / 2 * a 与 d / 2 * a（d = 7）
+    Expression folded = Expression::compile("7 / 2 * a"), symbolic = Expression::compile("d / 2 * a");
+    for (size_t i = 0; i < M; i++) {
+        double v1, v2, vars1[1] = { f64[0][i] }, vars2[2];
+        vars2[symbolic.variableIndex("d")] = 7;
+        vars2[symbolic.variableIndex("a")] = f64[0][i];
+        folded.evaluate(vars1, v1);
+        symbolic.evaluate(vars2, v2);
+        doubleMismatches += v1 != v2;
+    }
+    std::cout << "double batch vs scalar double mismatches: " << doubleMismatches << std::endl;
+}
+
+// 基准测试：生成一百万行表达式，单线程与多线程批量求值（输出写入临时文件）
+void benchmarkBulk(Benchmark& bench) {
+    const int N = 1000000;
+    srand(bench.config().seed + 2);
+    std::string text;
+    for (int i = 0; i < N; i++) {
+        text += std::to_string(rand() % 1000) + " * (" + std::to_string(rand() % 100) + " + " + std::to_string(rand() % 100)
+              + ") - " + std::to_string(rand() % 10000) + " / " + std::to_string(rand() % 50) + "\n";
+    }
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads : { 1u, hw }) {
+        FILE* sink = tmpfile();
+        if (!sink) return;
+        BulkEvaluator evaluator(threads);
+        size_t lines = 0;
+        bench.run("Bulk evaluate", std::to_string(threads) + " threads", N, [&] { rewind(sink); }, [&] {
+            BufferedWriter out(sink);
+            lines = evaluator.process(text.data(), text.size(), out);
+        });
+        fclose(sink);
+        if (lines != static_cast<size_t>(N)) std::cout << "Bulk evaluate processed " << lines << " lines, expected " << N << std::endl;
+        if (hw == 1) break;
+    }
+
+    // 正确性：随机短表达式（含非法记号）与 Expression 的状态和结果一致；超出 int64 的字面量按语法错误处理
+    const char alphabet[] = "0123456789+-*/() ";
+    size_t disagreements = 0;
+    for (int k = 0; k < 100000; k++) {
+        std::string line;
+        int len = 1 + rand() % 12;
+        for (int j = 0; j < len; j++) line += alphabet[rand() % (sizeof(alphabet) - 1)];
+        int64_t got = 0;
+        EvalStatus st = evaluateLine(line, got);
+        try {
+            int want = Expression::compile(line).evaluate();
+            disagreements += st != EVAL_OK || got != want;
+        }
+        catch (const std::invalid_argument& e) {
+            std::string why = e.what();
+            if (why == "常量超出范围" || why == "整数溢出") continue;   // 只超出 int，在 int64 下合法
+            disagreements += why == "除数不能为零" ? st != EVAL_DIV_ZERO : st == EVAL_OK;
+        }
+    }
+    struct { const char* line; EvalStatus status; int64_t value; } literals[] = {
+        { "9223372036854775807", EVAL_OK, INT64_MAX },
+        { "9223372036854775808", EVAL_SYNTAX, 0 },
+        { "20000000000000000000", EVAL_SYNTAX, 0 },
+        { "18446744073709551617 + 0", EVAL_SYNTAX, 0 },
+        { "0 - 9223372036854775807 - 1", EVAL_OK, INT64_MIN },
+    };
+    for (const auto& t : literals) {
+        int64_t got = 0;
+        EvalStatus st = evaluateLine(t.line, got);
+        disagreements += st != t.status || (st == EVAL_OK && got != t.value);
+    }
+    std::cout << "evaluateLine vs Expression disagreements: " << disagreements << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::string inputPath, outputPath;
+    unsigned threads = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--bench") {
+            Benchmark bench(BenchConfig::fromArgs(argc, argv));
+            benchmarkEvaluation(bench);
+            benchmarkBatch(bench);
+            benchmarkBulk(bench);
+            return 0;
+        }
+        if (arg == "--file" && i + 1 < argc) inputPath = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) outputPath = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    }
+
+    // 批量模式：--file 输入 [--out 输出] [--threads N]，每行一个表达式，结果按行输出（默认标准输出）
+    if (!inputPath.empty()) {
+        FILE* fp = outputPath.empty() ? stdout : fopen(outputPath.c_str(), "wb");
+        if (!fp) {
+            std::cerr << "错误: 无法写入 " << outputPath << std::endl;
+            return 1;
+        }
+        size_t lines = 0;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            BufferedWriter out(fp);
+            lines = BulkEvaluator(threads).processFile(inputPath.c_str(), out);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "错误: " << e.what() << std::endl;
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (fp != stdout) fclose(fp);
+        std::cerr << lines << " 个表达式, 用时 " << seconds << " 秒, " << (seconds > 0 ? lines / seconds : 0) << " 个/秒" << std::endl;
+        return 0;
+    }
+
     std::string expression;
     std::cout << "请输入一个表达式: ";
     std::getline(std::cin, expression);
 
     try {
-        int result = evaluate(expression);
+        Expression expr = Expression::compile(expression);
+        std::vector<int> vars(expr.variables.size());
+        for (size_t k = 0; k < vars.size(); k++) {      // 依次读入各变量的取值
+            std::cout << expr.variables[k] << " = ";
+            if (!(std::cin >> vars[k])) throw std::invalid_argument("无效的变量取值");
+        }
+        int result = expr.evaluate(vars);
         std::cout << "结果: " << result << std::endl;
     }
     catch (const std::exception& e) {
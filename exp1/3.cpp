@@ -1,31 +1,377 @@
 #include <iostream>
 #include <vector>
-#include <stack>
 #include <algorithm> // 包含 algorithm 头文件
 #include <sstream>   // 包含 stringstream 头文件
+#include <cstdint>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <stdexcept>
+#include "../Benchmark.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define RECT_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
-// 计算矩形最大面积的函数
-int largestRectangleArea(vector<int>& heights) {
-    stack<int> s; // 单调递增栈，存储柱子的索引
-    int max_area = 0;
-    heights.push_back(0); // 添加一个高度为0的柱子，方便处理栈中剩余的柱子
+// 流式最大矩形引擎：柱子逐个（或成批）送入，单调递增栈用数组存放 (位置, 高度)，不需要保存全部高度；
+// 面积按 64 位计算；负高度与 0 一样截断矩形（面积为负，不影响最大值）。collect 为 true 时记录“保留柱”，供分块并行时合并：
+//   - 出栈时栈已空的柱子：块内左侧没有更矮的柱子，左边界可能延伸到前面的块；
+//   - 结束时仍在栈中的柱子：块内右侧没有更矮的柱子，右边界可能延伸到后面的块。
+// 其余柱子左右两侧在块内都有更矮（或等高）的柱子，块内求出的面积就是全局面积。
+class RectangleEngine {
+public:
+    struct Bar {
+        int64_t pos;
+        int height;
+    };
+
+    explicit RectangleEngine(int64_t start = 0, bool collect = false) : stack(1024), collect(collect) { reset(start); }
+
+    void push(int h) {
+        while (top > 0 && stack[top].height > h) popTop(next, collect);
+        if (++top == stack.size()) stack.resize(stack.size() * 2);
+        stack[top] = { next++, h };
+    }
+    void push(const int* h, size_t n) {
+        for (size_t i = 0; i < n; i++) push(h[i]);
+    }
+
+    // 结束输入：以块末为右边界清空栈，返回最大面积
+    int64_t finish() {
+        if (collect) kept.insert(kept.end(), stack.begin() + 1, stack.begin() + top + 1);
+        while (top) popTop(next, false);
+        return best;
+    }
+
+    // 从位置 start 开始新的一段输入，保留栈的容量，逐行求解时不再重复分配
+    void reset(int64_t start = 0) {
+        stack[0] = { start - 1, INT_MIN };      // 哨兵：不低于任何 int 高度，出栈循环另有 top > 0 兜底
+        top = 0;
+        kept.clear();
+        next = start;
+        best = 0;
+    }
+
+    int64_t maxArea() const { return best; }
+    vector<Bar> kept;                           // 保留柱，按位置递增
+
+private:
+    vector<Bar> stack;                          // stack[0] 为哨兵，stack[1..top] 为栈内柱子
+    size_t top;
+    int64_t next;                               // 下一根柱子的位置
+    int64_t best = 0;
+    bool collect;
+
+    void popTop(int64_t right, bool keep) {
+        Bar bar = stack[top--];
+        best = max(best, static_cast<int64_t>(bar.height) * (right - stack[top].pos - 1));
+        if (keep && top == 0) kept.push_back(bar);
+    }
+};
+
+// 计算矩形最大面积的函数（不修改输入）
+int64_t largestRectangleArea(const vector<int>& heights) {
+    RectangleEngine engine;
+    engine.push(heights.data(), heights.size());
+    return engine.finish();
+}
 
-    for (int i = 0; i < heights.size(); ++i) {
-        while (!s.empty() && heights[s.top()] > heights[i]) {
-            int height = heights[s.top()];
-            s.pop();
-            int width = s.empty() ? i : i - s.top() - 1;
-            max_area = max(max_area, height * width);
+// 并行模式：分块各自求解并记录保留柱，再按位置顺序对所有保留柱做一遍单调栈。
+// 块内求得的面积都不超过真实值；每根柱子的完整范围要么在块内求出，要么在合并时由保留柱求出
+// minChunk 为每块最少柱数，过小的块不值得开线程
+int64_t largestRectangleParallel(const int* heights, size_t n, unsigned threads = 0, size_t minChunk = 1 << 16) {
+    if (!threads) threads = max(1u, thread::hardware_concurrency());
+    size_t chunks = min<size_t>(threads, max<size_t>(1, n / max<size_t>(minChunk, 1)));
+    size_t step = (n + chunks - 1) / max<size_t>(chunks, 1);
+    vector<int64_t> local(chunks, 0);
+    vector<vector<RectangleEngine::Bar>> kept(chunks);
+    auto solve = [&](size_t c) {
+        size_t lo = min(n, c * step), hi = min(n, lo + step);
+        RectangleEngine engine(static_cast<int64_t>(lo), true);
+        engine.push(heights + lo, hi - lo);
+        local[c] = engine.finish();
+        kept[c].swap(engine.kept);
+    };
+    vector<thread> pool;
+    for (size_t c = 1; c < chunks; c++) pool.emplace_back(solve, c);
+    solve(0);
+    for (auto& t : pool) t.join();
+
+    int64_t best = 0;
+    for (int64_t a : local) best = max(best, a);
+    vector<RectangleEngine::Bar> stack;         // 合并：位置不连续，宽度按位置差计算
+    auto popTop = [&](int64_t right) {
+        RectangleEngine::Bar top = stack.back();
+        stack.pop_back();
+        int64_t left = stack.empty() ? -1 : stack.back().pos;
+        best = max(best, static_cast<int64_t>(top.height) * (right - left - 1));
+    };
+    for (auto& bars : kept) {
+        for (const auto& bar : bars) {
+            while (!stack.empty() && stack.back().height > bar.height) popTop(bar.pos);
+            stack.push_back(bar);
         }
-        s.push(i);
     }
+    while (!stack.empty()) popTop(static_cast<int64_t>(n));
+    return best;
+}
 
-    return max_area;
+// 从二进制文件（小端 int32 高度序列）流式求解：按 4 MB 大块读入，内存占用只有读缓冲和单调栈
+int64_t largestRectangleFromStream(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) throw runtime_error(string("无法打开文件 ") + path);
+    vector<int> buf(1 << 20);
+    RectangleEngine engine;
+    size_t got;
+    while ((got = fread(buf.data(), sizeof(int), buf.size(), fp)) > 0) engine.push(buf.data(), got);
+    fclose(fp);
+    return engine.finish();
 }
 
-int main() {
+// 从二进制文件并行求解：支持 mmap 时直接映射，否则整体读入
+int64_t largestRectangleFromFile(const char* path, unsigned threads = 0) {
+#ifdef RECT_HAS_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) throw runtime_error(string("无法打开文件 ") + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); throw runtime_error(string("无法读取文件 ") + path); }
+    size_t n = static_cast<size_t>(st.st_size) / sizeof(int);
+    if (n == 0) { close(fd); return 0; }
+    void* p = mmap(nullptr, n * sizeof(int), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) throw runtime_error(string("无法映射文件 ") + path);
+    int64_t area = largestRectangleParallel(static_cast<const int*>(p), n, threads);
+    munmap(p, n * sizeof(int));
+    return area;
+#else
+    FILE* fp = fopen(path, "rb");
+    if (!fp) throw runtime_error(string("无法打开文件 ") + path);
+    vector<int> heights;
+    vector<int> buf(1 << 20);
+    size_t got;
+    while ((got = fread(buf.data(), sizeof(int), buf.size(), fp)) > 0) heights.insert(heights.end(), buf.begin(), buf.begin() + got);
+    fclose(fp);
+    return largestRectangleParallel(heights.data(), heights.size(), threads);
+#endif
+}
+
+// 二值矩阵最大全 1 矩形。矩阵按行位压缩：每行 (cols + 63) / 64 个字，第 j 列在第 j >> 6 个字的第 j & 63 位，
+// 行尾多余的位不必清零。逐行增量更新各列高度（连续 1 的个数），再对高度做一次最大矩形
+class MaximalRectangle {
+public:
+    MaximalRectangle(size_t cols) : cols(cols), words((cols + 63) / 64), heights(words * 64, 0) {}
+
+    static size_t rowWords(size_t cols) { return (cols + 63) / 64; }
+
+    // 依次送入一行，返回到目前为止的最大面积
+    int64_t addRow(const uint64_t* row) {
+        if (updateHeights(heights.data(), row, words)) {
+            engine.reset();
+            engine.push(heights.data(), cols);
+            best = max(best, engine.finish());
+        }
+        return best;
+    }
+
+    int64_t maxArea() const { return best; }
+    vector<int>& columnHeights() { return heights; }   // 长度按整字补齐，前 cols 项有效
+
+    // 按字更新高度：全 1 字整体加一，全 0 字整体清零；1 较少时只保留置位列，其余情况整体加一后
+    // 用 ctz 逐个清零 0 位。返回本行是否有 1
+    static bool updateHeights(int* h, const uint64_t* row, size_t words) {
+        bool any = false;
+        for (size_t w = 0; w < words; w++) {
+            uint64_t x = row[w];
+            int* p = h + w * 64;
+            if (x == ~uint64_t(0)) {
+                for (int k = 0; k < 64; k++) p[k]++;
+                any = true;
+            }
+            else if (x == 0) {
+                memset(p, 0, 64 * sizeof(int));
+            }
+            else if (__builtin_popcountll(x) <= 16) {
+                int keep[16], c = 0;
+                for (uint64_t y = x; y; y &= y - 1) keep[c++] = p[__builtin_ctzll(y)] + 1;
+                memset(p, 0, 64 * sizeof(int));
+                c = 0;
+                for (uint64_t y = x; y; y &= y - 1) p[__builtin_ctzll(y)] = keep[c++];
+                any = true;
+            }
+            else {
+                for (int k = 0; k < 64; k++) p[k]++;
+                for (uint64_t z = ~x; z; z &= z - 1) p[__builtin_ctzll(z)] = 0;
+                any = true;
+            }
+        }
+        return any;
+    }
+
+private:
+    size_t cols, words;
+    vector<int> heights;
+    RectangleEngine engine;                     // 栈缓冲跨行复用
+    int64_t best = 0;
+};
+
+// 顺序求解：bits 为 rows 行连续存放的位压缩矩阵
+int64_t maximalRectangle(const uint64_t* bits, size_t rows, size_t cols) {
+    MaximalRectangle solver(cols);
+    size_t words = MaximalRectangle::rowWords(cols);
+    for (size_t r = 0; r < rows; r++) solver.addRow(bits + r * words);
+    return solver.maxArea();
+}
+
+// 按行带并行，分两趟：
+//   1. 各带从零高度出发只更新高度，得到带末高度；某列高度等于带长说明该列整带全 1；
+//   2. 顺序合并出每带的起始高度（整带全 1 的列累加上一带的值，否则取带内结果），再各带并行逐行求解
+int64_t maximalRectangleParallel(const uint64_t* bits, size_t rows, size_t cols, unsigned threads = 0, size_t minBand = 64) {
+    if (!threads) threads = max(1u, thread::hardware_concurrency());
+    size_t bands = min<size_t>(threads, max<size_t>(1, rows / max<size_t>(minBand, 1)));
+    if (bands <= 1) return maximalRectangle(bits, rows, cols);
+    size_t words = MaximalRectangle::rowWords(cols);
+    size_t step = (rows + bands - 1) / bands;
+    auto runBands = [&](auto&& work) {
+        vector<thread> pool;
+        for (size_t b = 1; b < bands; b++) pool.emplace_back(work, b);
+        work(0);
+        for (auto& t : pool) t.join();
+    };
+
+    vector<vector<int>> tail(bands, vector<int>(words * 64, 0));
+    runBands([&](size_t b) {
+        size_t lo = min(rows, b * step), hi = min(rows, lo + step);
+        for (size_t r = lo; r < hi; r++) MaximalRectangle::updateHeights(tail[b].data(), bits + r * words, words);
+    });
+
+    vector<int64_t> local(bands, 0);
+    vector<int> carry(words * 64, 0);           // 第 b 带开始前的高度
+    vector<MaximalRectangle> solvers(bands, MaximalRectangle(cols));
+    for (size_t b = 0; b < bands; b++) {
+        solvers[b].columnHeights() = carry;
+        int len = static_cast<int>(min(rows, b * step + step) - min(rows, b * step));
+        for (size_t j = 0; j < cols; j++) carry[j] = tail[b][j] == len ? carry[j] + len : tail[b][j];
+    }
+    runBands([&](size_t b) {
+        size_t lo = min(rows, b * step), hi = min(rows, lo + step);
+        for (size_t r = lo; r < hi; r++) solvers[b].addRow(bits + r * words);
+        local[b] = solvers[b].maxArea();
+    });
+    return *max_element(local.begin(), local.end());
+}
+
+// 正确性：固定用例（含负高度、空输入、极大高度）与随机小用例对照 O(n^2) 暴力解，返回不一致的个数
+int checkRectangle() {
+    auto brute = [](const vector<int>& h) {
+        int64_t best = 0;
+        for (size_t i = 0; i < h.size(); i++) {
+            int low = INT_MAX;
+            for (size_t j = i; j < h.size(); j++) {
+                low = min(low, h[j]);
+                best = max(best, static_cast<int64_t>(low) * static_cast<int64_t>(j - i + 1));
+            }
+        }
+        return best;
+    };
+    vector<vector<int>> cases = { { 2, -3, 4 }, { 2, 1, 5, 6, 2, 3 }, {}, { -1, -2 }, { INT_MIN, 3, INT_MIN }, { INT_MAX, INT_MAX } };
+    srand(7);
+    for (int k = 0; k < 2000; k++) {
+        vector<int> h(rand() % 40);
+        for (auto& v : h) v = rand() % 11 - 3;
+        cases.push_back(h);
+    }
+    int failures = 0;
+    for (const auto& h : cases) {
+        int64_t want = brute(h);
+        failures += largestRectangleArea(h) != want;
+        failures += largestRectangleParallel(h.data(), h.size(), 1 + rand() % 6, 1) != want;
+    }
+    return failures;
+}
+
+// 基准测试：随机高度，顺序引擎与并行模式
+void benchmarkRectangle(Benchmark& bench) {
+    cout << "Largest rectangle checks: " << checkRectangle() << " failures" << endl;
+    const size_t N = size_t(1) << 25;
+    vector<int> heights(N);
+    srand(bench.config().seed);
+    for (auto& h : heights) h = rand() % 1000000;
+    int64_t a1 = 0, a2 = 0;
+    bench.run("Largest rectangle (stream)", "random", N, [] {}, [&] { a1 = largestRectangleArea(heights); });
+    unsigned hw = max(1u, thread::hardware_concurrency());
+    bench.run("Largest rectangle (parallel)", to_string(hw) + " threads", N, [] {},
+              [&] { a2 = largestRectangleParallel(heights.data(), N, hw); });
+    cout << "Areas " << a1 << " / " << a2 << (a1 == a2 ? " match" : " DIFFER") << endl;
+}
+
+// 基准测试：占用栅格（大片全 1，散布少量 0 与若干空白块），对比逐行取位调用 largestRectangleArea 的朴素做法
+void benchmarkMaximalRectangle(Benchmark& bench) {
+    const size_t R = 4096, C = 4096, W = MaximalRectangle::rowWords(C);
+    vector<uint64_t> bits(R * W, ~uint64_t(0));
+    srand(bench.config().seed + 1);
+    for (size_t k = 0; k < R * C / 64; k++) {
+        size_t r = rand() % R, c = rand() % C;
+        bits[r * W + c / 64] &= ~(uint64_t(1) << (c % 64));
+    }
+    for (int k = 0; k < 32; k++) {
+        size_t r0 = rand() % R, c0 = rand() % C;
+        for (size_t r = r0; r < min(R, r0 + 256); r++)
+            for (size_t c = c0; c < min(C, c0 + 256); c++) bits[r * W + c / 64] &= ~(uint64_t(1) << (c % 64));
+    }
+    int64_t a0 = 0, a1 = 0, a2 = 0;
+    bench.run("Maximal rectangle (naive per row)", "4096x4096", R * C, [] {}, [&] {
+        vector<int> heights(C, 0);
+        a0 = 0;
+        for (size_t r = 0; r < R; r++) {
+            for (size_t c = 0; c < C; c++) heights[c] = (bits[r * W + c / 64] >> (c % 64) & 1) ? heights[c] + 1 : 0;
+            a0 = max(a0, largestRectangleArea(heights));
+        }
+    });
+    bench.run("Maximal rectangle (bit-packed)", "4096x4096", R * C, [] {}, [&] { a1 = maximalRectangle(bits.data(), R, C); });
+    unsigned hw = max(1u, thread::hardware_concurrency());
+    bench.run("Maximal rectangle (row bands)", to_string(hw) + " threads", R * C, [] {},
+              [&] { a2 = maximalRectangleParallel(bits.data(), R, C, hw); });
+    cout << "Areas " << a0 << " / " << a1 << " / " << a2 << (a0 == a1 && a1 == a2 ? " match" : " DIFFER") << endl;
+}
+
+int main(int argc, char** argv) {
+    string filePath;
+    unsigned threads = 0;
+    bool stream = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--bench") {
+            Benchmark bench(BenchConfig::fromArgs(argc, argv));
+            benchmarkRectangle(bench);
+            benchmarkMaximalRectangle(bench);
+            return 0;
+        }
+        if (arg == "--file" && i + 1 < argc) filePath = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--stream") stream = true;
+    }
+
+    // 文件模式：--file 高度文件（小端 int32）[--stream 顺序流式读取 | --threads N 并行]
+    if (!filePath.empty()) {
+        try {
+            int64_t area = stream ? largestRectangleFromStream(filePath.c_str()) : largestRectangleFromFile(filePath.c_str(), threads);
+            cout << "最大矩形面积: " << area << endl;
+        }
+        catch (const exception& e) {
+            cerr << "错误: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
     string input;
     cout << "请输入柱子的高度: ";
     getline(cin, input);
@@ -10,32 +10,312 @@
 #define BITMAP_H
 
 #include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define BITMAP_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 位图：以 64 位字存储，第 k 位位于 M[k >> 6] 的第 (k & 63) 位（低位在前）
+// 字数总是 4 的倍数，批量运算每轮处理 256 位，便于编译器生成 SIMD 指令
+//
+// 持久化文件格式：32 字节文件头（魔数 "BMP1"、版本、字数、置位数、保留字段），随后是 N 个 64 位字。
+// 文件可直接映射为位图（只读或读写），启动时无需重建，多进程共享同一份页面。
 class Bitmap {
+public:
+    struct FileHeader {
+        char magic[4];          // "BMP1"
+        uint32_t version;       // 1
+        uint64_t words;         // 字数 N
+        uint64_t count;         // 置位数
+        uint64_t reserved;
+    };
+    enum MapMode { READ_ONLY, READ_WRITE };
+
 private:
-    unsigned char* M;
-    int N, _sz;
+    uint64_t* M;
+    int N, _sz;                 // N 为字数，_sz 为置位数
+    uint32_t* R;                // rank 索引：R[b] 为前 b 个超块（每块 8 字 = 512 位）中的置位数
+    int RN;                     // R 的长度，0 表示索引失效
+    char* _map;                 // 映射区首地址，nullptr 表示数据在堆上
+    size_t _mapLen;             // 映射区长度
+    int _fd;                    // 读写映射时保持打开的文件
+    bool _writable;             // 映射是否可写
+
+    void checkWritable() const {
+        if (_map && !_writable) throw std::logic_error("read-only mapped Bitmap cannot be modified");
+    }
+    FileHeader* header() const { return reinterpret_cast<FileHeader*>(_map); }
+    void release() {            // 释放堆内存或解除映射
+        invalidate();
+        if (!_map) { delete[] M; M = nullptr; return; }
+#ifdef BITMAP_HAS_MMAP
+        if (_writable) header()->count = _sz;
+        munmap(_map, _mapLen);
+        if (_fd >= 0) close(_fd);
+#endif
+        _map = nullptr; _fd = -1; M = nullptr;
+    }
+#ifdef BITMAP_HAS_MMAP
+    void mapFile(int fd, size_t len, bool writable) {
+        void* p = mmap(nullptr, len, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("mmap failed");
+        _map = static_cast<char*>(p);
+        _mapLen = len;
+        M = reinterpret_cast<uint64_t*>(_map + sizeof(FileHeader));
+    }
+#endif
     void init(int n) {
-        M = new unsigned char[N = (n + 7) / 8];
-        memset(M, 0, N);
+        N = std::max(4, ((n + 63) / 64 + 3) & ~3);
+        M = new uint64_t[N];
+        memset(M, 0, N * sizeof(uint64_t));
         _sz = 0;
+        R = nullptr; RN = 0;
+    }
+    void invalidate() { delete[] R; R = nullptr; RN = 0; }
+    void recount() {            // 批量运算后重新统计置位数
+        int c = 0;
+        for (int i = 0; i < N; i++) c += __builtin_popcountll(M[i]);
+        _sz = c;
+    }
+    void buildIndex() {         // 构造 rank/select 索引
+        RN = N / 8 + 2;
+        R = new uint32_t[RN];
+        uint32_t c = 0;
+        for (int b = 0; b < RN; b++) {
+            R[b] = c;
+            for (int i = b * 8; i < std::min(N, b * 8 + 8); i++) c += __builtin_popcountll(M[i]);
+        }
     }
 
 public:
-    Bitmap(int n = 8) { init(n); }
-    ~Bitmap() { delete[] M; M = nullptr; _sz = 0; }
+    Bitmap(int n = 8) : _map(nullptr), _mapLen(0), _fd(-1), _writable(true) { init(n); }
+    Bitmap(const Bitmap& other) : M(nullptr), R(nullptr), RN(0), _map(nullptr), _mapLen(0), _fd(-1), _writable(true) {
+        *this = other;
+    }
+    Bitmap(Bitmap&& other) noexcept
+        : M(other.M), N(other.N), _sz(other._sz), R(other.R), RN(other.RN),
+          _map(other._map), _mapLen(other._mapLen), _fd(other._fd), _writable(other._writable) {
+        other.M = nullptr; other.R = nullptr; other.RN = 0; other._map = nullptr; other._fd = -1;
+    }
+    Bitmap& operator=(const Bitmap& other) {    // 总是复制到堆上
+        if (this == &other) return *this;
+        release();
+        N = other.N; _sz = other._sz; _writable = true;
+        M = new uint64_t[N];
+        memcpy(M, other.M, N * sizeof(uint64_t));
+        return *this;
+    }
+    ~Bitmap() { release(); _sz = 0; }
 
-    void set(int k) { expand(k); _sz++; M[k >> 3] |= (0x80 >> (k & 0x07)); }
-    void clear(int k) { expand(k); _sz--; M[k >> 3] &= ~(0x80 >> (k & 0x07)); }
-    bool test(int k) { expand(k); return M[k >> 3] & (0x80 >> (k & 0x07)); }
+    // 从 save() 写出的文件加载：支持 mmap 的平台上直接映射（O(1)，不复制），
+    // READ_WRITE 模式下修改直接作用于文件，sync() 落盘；其他平台读入堆内存
+    Bitmap(const char* file, MapMode mode = READ_ONLY)
+        : M(nullptr), N(0), _sz(0), R(nullptr), RN(0), _map(nullptr), _mapLen(0), _fd(-1), _writable(mode == READ_WRITE) {
+        FileHeader h;
+#ifdef BITMAP_HAS_MMAP
+        int fd = open(file, _writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) throw std::runtime_error(std::string("cannot open bitmap file ") + file);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(h)) || pread(fd, &h, sizeof(h), 0) != sizeof(h)
+            || memcmp(h.magic, "BMP1", 4) != 0 || h.words % 4 || h.words > 0x7FFFFFFF / 64
+            || static_cast<uint64_t>(st.st_size) < sizeof(h) + h.words * 8) {
+            close(fd);
+            throw std::runtime_error(std::string("invalid bitmap file ") + file);
+        }
+        try {
+            mapFile(fd, sizeof(h) + h.words * 8, _writable);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        if (_writable) _fd = fd;
+        else close(fd);                         // 只读映射建立后即可关闭文件
+        N = static_cast<int>(h.words);
+        _sz = static_cast<int>(h.count);
+#else
+        FILE* fp = fopen(file, "rb");
+        if (!fp) throw std::runtime_error(std::string("cannot open bitmap file ") + file);
+        if (fread(&h, sizeof(h), 1, fp) != 1 || memcmp(h.magic, "BMP1", 4) != 0 || h.words % 4 || h.words > 0x7FFFFFFF / 64) {
+            fclose(fp);
+            throw std::runtime_error(std::string("invalid bitmap file ") + file);
+        }
+        N = static_cast<int>(h.words);
+        M = new uint64_t[N];
+        bool ok = fread(M, sizeof(uint64_t), N, fp) == static_cast<size_t>(N);
+        fclose(fp);
+        if (!ok) { delete[] M; M = nullptr; throw std::runtime_error(std::string("truncated bitmap file ") + file); }
+        _sz = static_cast<int>(h.count);
+        _writable = true;
+#endif
+    }
+
+    // 写出快照：文件头加数据区，直接从内存写出，不经中间缓冲
+    void save(const char* file) const {
+        FileHeader h;
+        memcpy(h.magic, "BMP1", 4);
+        h.version = 1;
+        h.words = N;
+        h.count = _sz;
+        h.reserved = 0;
+        FILE* fp = fopen(file, "wb");
+        if (!fp) throw std::runtime_error(std::string("cannot create bitmap file ") + file);
+        bool ok = fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(M, sizeof(uint64_t), N, fp) == static_cast<size_t>(N);
+        ok = (fclose(fp) == 0) && ok;
+        if (!ok) throw std::runtime_error(std::string("failed to write bitmap file ") + file);
+    }
+
+    // 读写映射：更新文件头并同步到磁盘；堆模式下无操作
+    void sync() {
+#ifdef BITMAP_HAS_MMAP
+        if (!_map || !_writable) return;
+        header()->count = _sz;
+        header()->words = N;
+        if (msync(_map, _mapLen, MS_SYNC) != 0) throw std::runtime_error("msync failed");
+#endif
+    }
+    bool mapped() const { return _map != nullptr; }
+
+    void set(int k) {
+        checkWritable();
+        expand(k);
+        uint64_t bit = uint64_t(1) << (k & 63);
+        if (M[k >> 6] & bit) return;
+        M[k >> 6] |= bit; _sz++; invalidate();
+    }
+    void clear(int k) {
+        checkWritable();
+        expand(k);
+        uint64_t bit = uint64_t(1) << (k & 63);
+        if (!(M[k >> 6] & bit)) return;
+        M[k >> 6] &= ~bit; _sz--; invalidate();
+    }
+    bool test(int k) const { return k < 64 * N && (M[k >> 6] >> (k & 63) & 1); }  // 越界视为未置位，不扩容
+
+    int size() const { return _sz; }           // 置位数
+    int capacity() const { return N * 64; }    // 当前可容纳的位数
 
     void expand(int k) {
-        if (k < 8 * N) return;
+        if (k < 64 * N) return;
+        checkWritable();
+#ifdef BITMAP_HAS_MMAP
+        if (_map) {                             // 读写映射：扩展文件后重新映射，新增部分由文件系统补零
+            int newN = std::max(4, ((2 * k + 63) / 64 + 3) & ~3);
+            size_t len = sizeof(FileHeader) + static_cast<size_t>(newN) * 8;
+            header()->count = _sz;
+            invalidate();
+            munmap(_map, _mapLen);
+            _map = nullptr; M = nullptr;
+            if (ftruncate(_fd, static_cast<off_t>(len)) != 0) {
+                close(_fd); _fd = -1; M = nullptr; N = 0; _sz = 0;
+                throw std::runtime_error("ftruncate failed");
+            }
+            mapFile(_fd, len, true);
+            N = newN;
+            header()->words = N;
+            return;
+        }
+#endif
         int oldN = N;
-        unsigned char* oldM = M;
+        uint64_t* oldM = M;
+        int sz = _sz;
+        invalidate();
         init(2 * k);
-        memcpy(M, oldM, oldN);
+        memcpy(M, oldM, oldN * sizeof(uint64_t));
         delete[] oldM;
+        _sz = sz;
+    }
+
+    // 批量运算：逐字处理整个位图
+    Bitmap& operator&=(const Bitmap& other) {
+        checkWritable();
+        int n = std::min(N, other.N);
+        uint64_t* __restrict a = M;
+        const uint64_t* __restrict b = other.M;
+        for (int i = 0; i < n; i += 4) {
+            a[i] &= b[i]; a[i + 1] &= b[i + 1]; a[i + 2] &= b[i + 2]; a[i + 3] &= b[i + 3];
+        }
+        if (n < N) memset(M + n, 0, (N - n) * sizeof(uint64_t));
+        recount(); invalidate();
+        return *this;
+    }
+    Bitmap& operator|=(const Bitmap& other) {
+        checkWritable();
+        if (other.N > N) expand(other.N * 64 - 1);
+        uint64_t* __restrict a = M;
+        const uint64_t* __restrict b = other.M;
+        for (int i = 0; i < other.N; i += 4) {
+            a[i] |= b[i]; a[i + 1] |= b[i + 1]; a[i + 2] |= b[i + 2]; a[i + 3] |= b[i + 3];
+        }
+        recount(); invalidate();
+        return *this;
+    }
+    Bitmap& operator^=(const Bitmap& other) {
+        checkWritable();
+        if (other.N > N) expand(other.N * 64 - 1);
+        uint64_t* __restrict a = M;
+        const uint64_t* __restrict b = other.M;
+        for (int i = 0; i < other.N; i += 4) {
+            a[i] ^= b[i]; a[i + 1] ^= b[i + 1]; a[i + 2] ^= b[i + 2]; a[i + 3] ^= b[i + 3];
+        }
+        recount(); invalidate();
+        return *this;
+    }
+    Bitmap& andNot(const Bitmap& other) {      // 差集：this & ~other
+        checkWritable();
+        int n = std::min(N, other.N);
+        uint64_t* __restrict a = M;
+        const uint64_t* __restrict b = other.M;
+        for (int i = 0; i < n; i += 4) {
+            a[i] &= ~b[i]; a[i + 1] &= ~b[i + 1]; a[i + 2] &= ~b[i + 2]; a[i + 3] &= ~b[i + 3];
+        }
+        recount(); invalidate();
+        return *this;
+    }
+
+    // 返回不小于 k 的第一个置位，没有则返回 -1
+    int next_set(int k) const {
+        if (k < 0) k = 0;
+        int i = k >> 6;
+        if (i >= N) return -1;
+        uint64_t w = M[i] & (~uint64_t(0) << (k & 63));
+        while (!w) {
+            if (++i >= N) return -1;
+            w = M[i];
+        }
+        return (i << 6) + __builtin_ctzll(w);
+    }
+
+    // 秩：[0, k) 中置位的个数，O(1)
+    int rank(int k) {
+        if (k <= 0) return 0;
+        if (k >= N * 64) return _sz;
+        if (!RN) buildIndex();
+        int i = k >> 6, c = R[i >> 3];
+        for (int j = i & ~7; j < i; j++) c += __builtin_popcountll(M[j]);
+        if (k & 63) c += __builtin_popcountll(M[i] & ((uint64_t(1) << (k & 63)) - 1));
+        return c;
+    }
+
+    // 选择：第 r 个（从 0 起）置位的位置，r 越界时返回 -1
+    int select(int r) {
+        if (r < 0 || r >= _sz) return -1;
+        if (!RN) buildIndex();
+        int b = static_cast<int>(std::upper_bound(R, R + RN, static_cast<uint32_t>(r)) - R) - 1;
+        r -= R[b];
+        int i = b * 8;
+        for (int c; (c = __builtin_popcountll(M[i])) <= r; i++) r -= c;
+        uint64_t w = M[i];
+        while (r--) w &= w - 1;
+        return (i << 6) + __builtin_ctzll(w);
     }
 };
 #endif // BITMAP_H
@@ -0,0 +1,123 @@
+#ifndef CONCURRENT_BITMAP_H
+#define CONCURRENT_BITMAP_H
+
+#include <atomic>
+#include <cstdint>
+
+// 并发位图：多线程可同时 set / clear / test，适合并行遍历中的 visited 集合与去重。
+// 每次修改是一条 64 位原子 fetch_or / fetch_and；test_and_set 的返回值可用于“认领”元素。
+
+// 容量固定的并发位图
+class ConcurrentBitmap {
+private:
+    std::atomic<uint64_t>* M;
+    int N;                      // 字数
+
+public:
+    explicit ConcurrentBitmap(int n) : N((n + 63) / 64) {
+        M = new std::atomic<uint64_t>[N];
+        for (int i = 0; i < N; i++) M[i].store(0, std::memory_order_relaxed);
+    }
+    ConcurrentBitmap(const ConcurrentBitmap&) = delete;
+    ConcurrentBitmap& operator=(const ConcurrentBitmap&) = delete;
+    ~ConcurrentBitmap() { delete[] M; }
+
+    int capacity() const { return N * 64; }
+
+    // 置位并返回原值：返回 false 表示本线程首次置位
+    bool test_and_set(int k) {
+        uint64_t bit = uint64_t(1) << (k & 63);
+        return M[k >> 6].fetch_or(bit, std::memory_order_acq_rel) & bit;
+    }
+    // 清零并返回原值
+    bool test_and_clear(int k) {
+        uint64_t bit = uint64_t(1) << (k & 63);
+        return M[k >> 6].fetch_and(~bit, std::memory_order_acq_rel) & bit;
+    }
+    void set(int k) { test_and_set(k); }
+    void clear(int k) { test_and_clear(k); }
+    bool test(int k) const { return M[k >> 6].load(std::memory_order_acquire) >> (k & 63) & 1; }
+
+    // 置位数；与写操作并发时只是某一时刻附近的近似值
+    int size() const {
+        int c = 0;
+        for (int i = 0; i < N; i++) c += __builtin_popcountll(M[i].load(std::memory_order_relaxed));
+        return c;
+    }
+};
+
+// 可增长的并发位图：分段存储，第 s 段容纳 2^(s + BASE_BITS) 位，段只分配不搬迁也不释放（析构除外），
+// 读者因此永远不会访问到已释放的缓冲区。新段由首个访问者分配，通过 CAS 发布，失败者释放自己的副本。
+class GrowableConcurrentBitmap {
+private:
+    static const int BASE_BITS = 16;            // 第 0 段 2^16 位
+    static const int SEGMENTS = 32 - BASE_BITS; // 覆盖全部非负 int
+    std::atomic<std::atomic<uint64_t>*> dir[SEGMENTS];
+
+    // 第 k 位所在的段与段内偏移
+    static void locate(int k, int& seg, uint32_t& offset) {
+        uint32_t idx = static_cast<uint32_t>(k) + (uint32_t(1) << BASE_BITS);
+        seg = 31 - __builtin_clz(idx) - BASE_BITS;
+        offset = idx - (uint32_t(1) << (seg + BASE_BITS));
+    }
+    static uint32_t segmentWords(int seg) { return (uint32_t(1) << (seg + BASE_BITS)) / 64; }
+
+    std::atomic<uint64_t>* segment(int seg) {   // 取段，不存在则分配
+        std::atomic<uint64_t>* s = dir[seg].load(std::memory_order_acquire);
+        if (s) return s;
+        uint32_t words = segmentWords(seg);
+        std::atomic<uint64_t>* fresh = new std::atomic<uint64_t>[words];
+        for (uint32_t i = 0; i < words; i++) fresh[i].store(0, std::memory_order_relaxed);
+        if (dir[seg].compare_exchange_strong(s, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+            return fresh;
+        delete[] fresh;                         // 其他线程已抢先发布
+        return s;
+    }
+
+public:
+    GrowableConcurrentBitmap() {
+        for (int s = 0; s < SEGMENTS; s++) dir[s].store(nullptr, std::memory_order_relaxed);
+    }
+    GrowableConcurrentBitmap(const GrowableConcurrentBitmap&) = delete;
+    GrowableConcurrentBitmap& operator=(const GrowableConcurrentBitmap&) = delete;
+    ~GrowableConcurrentBitmap() {
+        for (int s = 0; s < SEGMENTS; s++) delete[] dir[s].load(std::memory_order_relaxed);
+    }
+
+    bool test_and_set(int k) {
+        int seg;
+        uint32_t off;
+        locate(k, seg, off);
+        uint64_t bit = uint64_t(1) << (off & 63);
+        return segment(seg)[off >> 6].fetch_or(bit, std::memory_order_acq_rel) & bit;
+    }
+    bool test_and_clear(int k) {
+        int seg;
+        uint32_t off;
+        locate(k, seg, off);
+        std::atomic<uint64_t>* s = dir[seg].load(std::memory_order_acquire);
+        if (!s) return false;                   // 未分配的段全为 0
+        uint64_t bit = uint64_t(1) << (off & 63);
+        return s[off >> 6].fetch_and(~bit, std::memory_order_acq_rel) & bit;
+    }
+    void set(int k) { test_and_set(k); }
+    void clear(int k) { test_and_clear(k); }
+    bool test(int k) const {
+        int seg;
+        uint32_t off;
+        locate(k, seg, off);
+        std::atomic<uint64_t>* s = dir[seg].load(std::memory_order_acquire);
+        return s && (s[off >> 6].load(std::memory_order_acquire) >> (off & 63) & 1);
+    }
+
+    int size() const {                          // 与写操作并发时为近似值
+        int c = 0;
+        for (int seg = 0; seg < SEGMENTS; seg++) {
+            std::atomic<uint64_t>* s = dir[seg].load(std::memory_order_acquire);
+            if (!s) continue;
+            for (uint32_t i = 0; i < segmentWords(seg); i++) c += __builtin_popcountll(s[i].load(std::memory_order_relaxed));
+        }
+        return c;
+    }
+};
+#endif // CONCURRENT_BITMAP_H
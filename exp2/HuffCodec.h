@@ -0,0 +1,558 @@
+#ifndef HUFF_CODEC_H
+#define HUFF_CODEC_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HUFF_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 字节流哈夫曼编解码器：编码输出紧凑的位流（低位在前），解码还原原始字节。
+// 使用限长的规范哈夫曼码，码表只需保存各符号码长；解码按两级查找表进行，
+// 一次查表解出一个符号（码长不超过 ROOT_BITS 时只查一级）。
+//
+// 压缩格式：
+//   "HUF2" | 原始长度 u64 | 码表 | 位流
+//   码表：256 位的符号存在位图，随后每个出现的符号 4 位码长
+// 分块格式（大文件并行编解码、按块随机访问）：
+//   "HUFC" | 原始长度 u64 | 块长 u32 | 块数 u32 | 码表 | 块索引 (块数 + 1) × u64 | 各块位流
+//   所有块共用一张码表；块索引为各块位流相对数据区起点的字节偏移，每块按字节对齐
+
+// 64 位缓冲的位写入器：攒够后整字写出
+class BitWriter {
+private:
+    std::vector<uint8_t>& out;
+    uint64_t buf = 0;
+    int bits = 0;
+
+    void flush() {                              // 写出缓冲区中的整字节
+        size_t pos = out.size();
+        out.resize(pos + 8);
+        memcpy(&out[pos], &buf, 8);
+        int bytes = bits >> 3;
+        out.resize(pos + bytes);
+        buf = bytes == 8 ? 0 : buf >> (bytes * 8);
+        bits &= 7;
+    }
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& o) : out(o) {}
+    void put(uint64_t code, int len) {          // 写入 code 的低 len 位（len <= 57）
+        if (bits + len > 64) flush();
+        buf |= code << bits;
+        bits += len;
+    }
+    void finish() {                             // 写出剩余位，末字节高位补零
+        flush();
+        if (bits) { out.push_back(static_cast<uint8_t>(buf)); buf = 0; bits = 0; }
+    }
+};
+
+// 64 位缓冲的位读取器
+class BitReader {
+private:
+    const uint8_t* in;
+    size_t size, pos;
+    uint64_t buf = 0;
+    int bits = 0;
+
+public:
+    BitReader(const uint8_t* data, size_t n, size_t start = 0) : in(data), size(n), pos(start) {}
+    void refill() {                             // 尽量填满缓冲区（至少 57 位，除非输入结束）
+        if (pos + 8 <= size) {
+            uint64_t w;
+            memcpy(&w, in + pos, 8);
+            buf |= w << bits;
+            pos += (63 - bits) >> 3;
+            bits |= 56;
+            return;
+        }
+        while (bits <= 56 && pos < size) { buf |= uint64_t(in[pos++]) << bits; bits += 8; }
+    }
+    uint64_t peek() const { return buf; }
+    int available() const { return bits; }
+    void consume(int n) { buf >>= n; bits -= n; }
+    uint64_t get(int n) {                       // 读取 n 位（n <= 56）
+        if (bits < n) refill();
+        if (bits < n) throw std::runtime_error("truncated Huffman stream");
+        uint64_t v = buf & ((uint64_t(1) << n) - 1);
+        consume(n);
+        return v;
+    }
+};
+
+// Moffat–Katajainen 原地算法：A[0..n) 为升序排列的频率，返回时 A[i] 为对应符号的哈夫曼码长。
+// 第一遍用双队列（未合并的叶子 / 按生成顺序递增的内部节点）合并，内部节点的权值与父指针复用 A 的前部；
+// 第二遍由根向下求内部节点深度；第三遍按深度逐层统计可用节点，给叶子分配码长。O(n) 时间，O(1) 额外空间。
+inline void huffmanLengthsInPlace(uint64_t* A, int n) {
+    if (n == 0) return;
+    if (n == 1) { A[0] = 0; return; }
+    A[0] += A[1];
+    int root = 0, leaf = 2;
+    for (int next = 1; next < n - 1; next++) {
+        if (leaf >= n || A[root] < A[leaf]) { A[next] = A[root]; A[root++] = next; }
+        else A[next] = A[leaf++];
+        if (leaf >= n || (root < next && A[root] < A[leaf])) { A[next] += A[root]; A[root++] = next; }
+        else A[next] += A[leaf++];
+    }
+    A[n - 2] = 0;
+    for (int next = n - 3; next >= 0; next--) A[next] = A[A[next]] + 1;
+    int avail = 1, used = 0, next = n - 1;
+    uint64_t depth = 0;
+    root = n - 2;
+    while (avail > 0) {
+        while (root >= 0 && A[root] == depth) { used++; root--; }
+        while (avail > used) { A[next--] = depth; avail--; }
+        avail = 2 * used;
+        depth++;
+        used = 0;
+    }
+}
+
+// 字节频率统计：四张表轮流计数，相邻的相同字节落在不同表中，避免对同一计数器的连续读改写
+// 互相等待（store-forwarding 停顿）；32 位计数器每 1 GB 汇总一次到 64 位结果，防止溢出
+inline void countBytes(const uint8_t* data, size_t n, uint64_t freq[256]) {
+    const size_t BLOCK = size_t(1) << 30;
+    uint32_t t[4][256];
+    for (size_t base = 0; base < n; base += BLOCK) {
+        size_t end = std::min(n, base + BLOCK), i = base;
+        memset(t, 0, sizeof(t));
+        for (; i + 8 <= end; i += 8) {
+            uint64_t w;
+            memcpy(&w, data + i, 8);
+            t[0][w & 0xFF]++;         t[1][(w >> 8) & 0xFF]++;
+            t[2][(w >> 16) & 0xFF]++; t[3][(w >> 24) & 0xFF]++;
+            t[0][(w >> 32) & 0xFF]++; t[1][(w >> 40) & 0xFF]++;
+            t[2][(w >> 48) & 0xFF]++; t[3][w >> 56]++;
+        }
+        for (; i < end; i++) t[0][data[i]]++;
+        for (int c = 0; c < 256; c++) freq[c] += uint64_t(t[0][c]) + t[1][c] + t[2][c] + t[3][c];
+    }
+}
+
+inline unsigned huffThreads(unsigned threads) {
+    if (threads) return threads;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+// 用 threads 个线程处理 count 个任务，任务号由原子计数器分发；任务抛出的第一个异常在汇合后重新抛出
+template <typename F>
+void huffParallelFor(size_t count, unsigned threads, F f) {
+    threads = static_cast<unsigned>(std::min<size_t>(huffThreads(threads), count));
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++) f(i);
+        return;
+    }
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex errorLock;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back([&] {
+            try {
+                for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) f(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!error) error = std::current_exception();
+                next.store(count, std::memory_order_relaxed);   // 让其他线程尽快停下
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    if (error) std::rethrow_exception(error);
+}
+
+// 多线程频率统计：每个线程统计一段到自己的 256 项数组，最后合并（结果累加到 freq）
+inline void parallelCountBytes(const uint8_t* data, size_t n, uint64_t freq[256], unsigned threads = 0) {
+    const size_t MIN_SLICE = size_t(1) << 20;
+    size_t slices = std::max<size_t>(1, std::min<size_t>(huffThreads(threads), n / MIN_SLICE));
+    std::vector<uint64_t> local(slices * 256, 0);
+    size_t step = (n + slices - 1) / slices;
+    huffParallelFor(slices, threads, [&](size_t k) {
+        size_t lo = std::min(n, k * step), hi = std::min(n, lo + step);
+        countBytes(data + lo, hi - lo, &local[k * 256]);
+    });
+    for (size_t k = 0; k < slices; k++) for (int c = 0; c < 256; c++) freq[c] += local[k * 256 + c];
+}
+
+// 只读文件映射：支持 mmap 的平台直接映射整个文件（按顺序访问提示内核预读），否则按大块读入内存
+class MappedFile {
+private:
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+    std::vector<uint8_t> _buffer;               // 无 mmap 时的后备存储
+    bool _mapped = false;
+
+public:
+    explicit MappedFile(const char* file) {
+#ifdef HUFF_HAS_MMAP
+        int fd = open(file, O_RDONLY);
+        if (fd < 0) throw std::runtime_error(std::string("cannot open file ") + file);
+        struct stat st;
+        if (fstat(fd, &st) != 0) { close(fd); throw std::runtime_error(std::string("cannot stat file ") + file); }
+        _size = static_cast<size_t>(st.st_size);
+        if (_size) {
+            void* p = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) { close(fd); throw std::runtime_error(std::string("cannot map file ") + file); }
+            madvise(p, _size, MADV_SEQUENTIAL);
+            _data = static_cast<const uint8_t*>(p);
+            _mapped = true;
+        }
+        close(fd);
+#else
+        FILE* fp = fopen(file, "rb");
+        if (!fp) throw std::runtime_error(std::string("cannot open file ") + file);
+        const size_t BLOCK = size_t(1) << 24;
+        size_t got;
+        do {
+            size_t pos = _buffer.size();
+            _buffer.resize(pos + BLOCK);
+            got = fread(&_buffer[pos], 1, BLOCK, fp);
+            _buffer.resize(pos + got);
+        } while (got == BLOCK);
+        fclose(fp);
+        _data = _buffer.data();
+        _size = _buffer.size();
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+#ifdef HUFF_HAS_MMAP
+        if (_mapped) munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+    }
+
+    const uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+};
+
+class HuffCodec {
+public:
+    static const int MAX_CODE_LEN = 15;         // 码长上限
+    static const int ROOT_BITS = 11;            // 一级查找表索引位数
+
+    uint64_t code[256];                         // 各符号码字（低位先发送）
+    uint8_t len[256];                           // 各符号码长，0 表示未出现
+
+    // 根据频率构造码表
+    void build(const uint64_t freq[256]) {
+        buildLengths(freq);
+        limitLengths(freq);
+        assignCodes();
+    }
+
+    // 编码整段数据
+    std::vector<uint8_t> encode(const uint8_t* data, size_t n) {
+        uint64_t freq[256] = {};
+        countBytes(data, n, freq);
+        build(freq);
+        std::vector<uint8_t> out;
+        out.insert(out.end(), { 'H', 'U', 'F', '2' });
+        putLE(out, n, 8);
+        writeTable(out);
+        uint64_t total = 0;
+        for (int c = 0; c < 256; c++) total += freq[c] * len[c];
+        out.reserve(out.size() + total / 8 + 16);
+        encodeSymbols(data, n, out);
+        return out;
+    }
+
+    // 解码 encode() 的输出
+    static std::vector<uint8_t> decode(const std::vector<uint8_t>& in) { return decode(in.data(), in.size()); }
+    static std::vector<uint8_t> decode(const uint8_t* in, size_t size) {
+        if (size < 12 || memcmp(in, "HUF2", 4) != 0) throw std::runtime_error("invalid Huffman stream");
+        HuffCodec codec;
+        uint64_t n = getLE(in + 4, 8);
+        size_t pos = codec.readTable(in, size, 12);
+        // 每个符号至少 1 比特：先用剩余数据量约束头部声明的长度，再分配输出
+        if (n > 8 * uint64_t(size - pos)) throw std::runtime_error("invalid Huffman stream");
+        std::vector<Entry> table = codec.decodingTable();
+        std::vector<uint8_t> out(n);
+        decodeSymbols(table.data(), in, size, pos, out.data(), n);
+        return out;
+    }
+
+    // 分块编码：先多线程统计全局频率建一张共用码表，再由 threads 个线程并行编码各块，
+    // 最后按块序拼接并写出块索引（threads 为 0 时取硬件线程数）
+    std::vector<uint8_t> encodeChunked(const uint8_t* data, size_t n, uint32_t chunkSize = 1 << 20, unsigned threads = 0) {
+        if (!chunkSize) throw std::invalid_argument("chunk size must be positive");
+        uint64_t freq[256] = {};
+        parallelCountBytes(data, n, freq, threads);
+        build(freq);
+        size_t chunks = (n + chunkSize - 1) / chunkSize;
+        if (chunks > UINT32_MAX) throw std::invalid_argument("too many chunks");
+        std::vector<std::vector<uint8_t>> parts(chunks);
+        huffParallelFor(chunks, threads, [&](size_t k) {
+            size_t lo = k * chunkSize, cnt = std::min<size_t>(chunkSize, n - lo);
+            parts[k].reserve(cnt / 2 + 16);
+            encodeSymbols(data + lo, cnt, parts[k]);
+        });
+        std::vector<uint8_t> out;
+        out.insert(out.end(), { 'H', 'U', 'F', 'C' });
+        putLE(out, n, 8);
+        putLE(out, chunkSize, 4);
+        putLE(out, chunks, 4);
+        writeTable(out);
+        uint64_t offset = 0, total = 0;
+        for (auto& part : parts) total += part.size();
+        out.reserve(out.size() + 8 * (chunks + 1) + total);
+        for (size_t k = 0; k <= chunks; k++) {
+            putLE(out, offset, 8);
+            if (k < chunks) offset += parts[k].size();
+        }
+        for (auto& part : parts) {
+            out.insert(out.end(), part.begin(), part.end());
+            std::vector<uint8_t>().swap(part);  // 及早释放，峰值内存约为输出的两倍
+        }
+        return out;
+    }
+
+    // 解码 encodeChunked() 的输出，各块由 threads 个线程并行解码
+    static std::vector<uint8_t> decodeChunked(const uint8_t* in, size_t size, unsigned threads = 0);
+    static std::vector<uint8_t> decodeChunked(const std::vector<uint8_t>& in, unsigned threads = 0) {
+        return decodeChunked(in.data(), in.size(), threads);
+    }
+
+private:
+    friend class HuffChunkReader;
+
+    static void putLE(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+        for (int b = 0; b < bytes; b++) out.push_back(static_cast<uint8_t>(v >> (8 * b)));
+    }
+    static uint64_t getLE(const uint8_t* p, int bytes) {
+        uint64_t v = 0;
+        for (int b = 0; b < bytes; b++) v |= uint64_t(p[b]) << (8 * b);
+        return v;
+    }
+
+    void encodeSymbols(const uint8_t* data, size_t n, std::vector<uint8_t>& out) const {
+        BitWriter w(out);
+        for (size_t i = 0; i < n; i++) w.put(code[data[i]], len[data[i]]);
+        w.finish();
+    }
+
+    // 查找表项：一级表中 sub > 0 表示跳转到从 symbol 开始、索引 sub 位的二级表；len 为 0 表示无效码
+    struct Entry {
+        uint16_t symbol;
+        uint8_t len;
+        uint8_t sub;
+    };
+
+    // 求各符号的最优码长（不限长）：按频率升序排好后原地计算，不分配内存
+    void buildLengths(const uint64_t f[256]) {
+        int order[256], m = 0;
+        uint64_t A[256];
+        memset(len, 0, sizeof(len));
+        for (int c = 0; c < 256; c++) if (f[c]) order[m++] = c;
+        std::sort(order, order + m, [&](int a, int b) { return f[a] != f[b] ? f[a] < f[b] : a < b; });
+        for (int i = 0; i < m; i++) A[i] = f[order[i]];
+        huffmanLengthsInPlace(A, m);
+        for (int i = 0; i < m; i++) len[order[i]] = static_cast<uint8_t>(std::min<uint64_t>(std::max<uint64_t>(A[i], 1), 255));
+    }
+
+    // 把码长截断到 MAX_CODE_LEN 并恢复 Kraft 不等式：
+    // 超出的容量由频率最低的符号逐个加长码字偿还，之后若有余量再缩短高频符号的码字
+    void limitLengths(const uint64_t f[256]) {
+        int order[256], m = 0;
+        bool over = false;
+        for (int c = 0; c < 256; c++) {
+            if (!len[c]) continue;
+            order[m++] = c;
+            over = over || len[c] > MAX_CODE_LEN;
+        }
+        if (!over) return;
+        std::sort(order, order + m, [&](int a, int b) { return f[a] != f[b] ? f[a] > f[b] : a < b; });
+        const int64_t full = int64_t(1) << MAX_CODE_LEN;    // Kraft 和以 2^-MAX_CODE_LEN 为单位
+        int64_t kraft = 0;
+        for (int i = 0; i < m; i++) {
+            int c = order[i];
+            if (len[c] > MAX_CODE_LEN) len[c] = MAX_CODE_LEN;
+            kraft += full >> len[c];
+        }
+        for (int i = m - 1; kraft > full; i = i > 0 ? i - 1 : m - 1) {
+            int c = order[i];
+            if (len[c] < MAX_CODE_LEN) {
+                len[c]++;
+                kraft -= full >> len[c];
+            }
+        }
+        for (int i = 0; i < m; i++) {
+            int c = order[i];
+            while (len[c] > 1 && kraft + (full >> len[c]) <= full) {
+                kraft += full >> len[c];
+                len[c]--;
+            }
+        }
+    }
+
+    // 由码长分配码字：按 (码长, 符号) 顺序依次递增（规范码），再按发送顺序翻转位序
+    void assignCodes() {
+        int order[256], m = 0;
+        for (int c = 0; c < 256; c++) if (len[c]) order[m++] = c;
+        std::sort(order, order + m, [&](int a, int b) { return len[a] != len[b] ? len[a] < len[b] : a < b; });
+        uint64_t next = 0;
+        int prevLen = m ? len[order[0]] : 0;
+        for (int i = 0; i < m; i++) {
+            int c = order[i];
+            next <<= len[c] - prevLen;
+            prevLen = len[c];
+            uint64_t rev = 0;
+            for (int b = 0; b < len[c]; b++) rev |= ((next >> b) & 1) << (len[c] - 1 - b);
+            code[c] = rev;
+            next++;
+        }
+    }
+
+    // 码表：存在位图 + 各符号 4 位码长
+    void writeTable(std::vector<uint8_t>& out) const {
+        BitWriter w(out);
+        for (int c = 0; c < 256; c += 32) {
+            uint64_t present = 0;
+            for (int k = 0; k < 32; k++) present |= uint64_t(len[c + k] != 0) << k;
+            w.put(present, 32);
+        }
+        for (int c = 0; c < 256; c++) if (len[c]) w.put(len[c], 4);
+        w.finish();
+    }
+
+    // 从 in[pos] 读码表并分配码字，返回码表之后的位置
+    size_t readTable(const uint8_t* in, size_t size, size_t pos) {
+        if (size < pos + 32) throw std::runtime_error("invalid Huffman stream");
+        BitReader r(in, size, pos);
+        for (int c = 0; c < 256; c += 32) {
+            uint64_t present = r.get(32);
+            for (int k = 0; k < 32; k++) len[c + k] = (present >> k) & 1;
+        }
+        int m = 0;
+        for (int c = 0; c < 256; c++) {
+            if (!len[c]) continue;
+            len[c] = static_cast<uint8_t>(r.get(4));
+            if (!len[c]) throw std::runtime_error("invalid Huffman code length");
+            m++;
+        }
+        uint64_t kraft = 0;                     // 码长必须满足 Kraft 不等式，否则码字会重叠
+        for (int c = 0; c < 256; c++) if (len[c]) kraft += uint64_t(1) << (MAX_CODE_LEN - len[c]);
+        if (kraft > (uint64_t(1) << MAX_CODE_LEN)) throw std::runtime_error("invalid Huffman code table");
+        assignCodes();
+        return pos + 32 + (4 * m + 7) / 8;
+    }
+
+    // 从 in[pos, size) 解出 n 个符号
+    static void decodeSymbols(const Entry* root, const uint8_t* in, size_t size, size_t pos, uint8_t* out, size_t n) {
+        BitReader r(in, size, pos);
+        for (size_t i = 0; i < n; i++) {
+            if (r.available() < MAX_CODE_LEN) r.refill();
+            uint64_t bits = r.peek();
+            Entry e = root[bits & ((1 << ROOT_BITS) - 1)];
+            if (e.sub) e = root[e.symbol + ((bits >> ROOT_BITS) & ((1 << e.sub) - 1))];
+            if (!e.len) throw std::runtime_error("invalid Huffman code");
+            if (e.len > r.available()) throw std::runtime_error("truncated Huffman stream");
+            r.consume(e.len);
+            out[i] = static_cast<uint8_t>(e.symbol);
+        }
+    }
+
+    // 两级查找表：一级表以接下来的 ROOT_BITS 位为下标；更长的码字按前 ROOT_BITS 位分组，
+    // 每组一张二级表，大小由组内最长码决定，追加在一级表之后
+    std::vector<Entry> decodingTable() const {
+        const int rootSize = 1 << ROOT_BITS, rootMask = rootSize - 1;
+        int subBits[1 << ROOT_BITS] = {};
+        for (int c = 0; c < 256; c++) {
+            if (len[c] > ROOT_BITS) {
+                int& b = subBits[code[c] & rootMask];
+                b = std::max(b, len[c] - ROOT_BITS);
+            }
+        }
+        std::vector<Entry> table(rootSize, Entry{ 0, 0, 0 });
+        for (int p = 0; p < rootSize; p++) {
+            if (!subBits[p]) continue;
+            table[p] = Entry{ static_cast<uint16_t>(table.size()), 0, static_cast<uint8_t>(subBits[p]) };
+            table.resize(table.size() + (size_t(1) << subBits[p]), Entry{ 0, 0, 0 });
+        }
+        for (int c = 0; c < 256; c++) {
+            int l = len[c];
+            if (!l) continue;
+            Entry e{ static_cast<uint16_t>(c), static_cast<uint8_t>(l), 0 };
+            if (l <= ROOT_BITS) {
+                for (uint64_t k = code[c]; k < uint64_t(rootSize); k += uint64_t(1) << l) table[k] = e;
+            } else {
+                const Entry& link = table[code[c] & rootMask];
+                int rest = l - ROOT_BITS;
+                for (uint64_t k = code[c] >> ROOT_BITS; k < (uint64_t(1) << link.sub); k += uint64_t(1) << rest)
+                    table[link.symbol + k] = e;
+            }
+        }
+        return table;
+    }
+};
+
+// 分块流的读取器：解析一次文件头与码表，之后可按块号随机解码，in 须在读取器存活期间有效
+class HuffChunkReader {
+private:
+    const uint8_t* in;
+    size_t size;
+    uint64_t n;
+    uint32_t chunkSize, chunks;
+    const uint8_t* index;                       // 块索引
+    size_t dataStart;                           // 数据区起点
+    std::vector<HuffCodec::Entry> table;
+
+public:
+    HuffChunkReader(const uint8_t* data, size_t sz) : in(data), size(sz) {
+        if (size < 20 || memcmp(in, "HUFC", 4) != 0) throw std::runtime_error("invalid chunked Huffman stream");
+        n = HuffCodec::getLE(in + 4, 8);
+        chunkSize = static_cast<uint32_t>(HuffCodec::getLE(in + 12, 4));
+        chunks = static_cast<uint32_t>(HuffCodec::getLE(in + 16, 4));
+        if (!chunkSize || (n + chunkSize - 1) / chunkSize != chunks) throw std::runtime_error("invalid chunked Huffman stream");
+        HuffCodec codec;
+        size_t pos = codec.readTable(in, size, 20);
+        if ((size - pos) / 8 < uint64_t(chunks) + 1) throw std::runtime_error("truncated chunked Huffman stream");
+        index = in + pos;
+        dataStart = pos + 8 * (size_t(chunks) + 1);
+        if (HuffCodec::getLE(index + 8 * size_t(chunks), 8) > size - dataStart) throw std::runtime_error("truncated chunked Huffman stream");
+        if (n > 8 * uint64_t(size - dataStart)) throw std::runtime_error("invalid chunked Huffman stream");   // 每个符号至少 1 比特
+        table = codec.decodingTable();
+    }
+
+    uint64_t length() const { return n; }
+    uint32_t chunkCount() const { return chunks; }
+    size_t chunkLength(size_t k) const { return std::min<uint64_t>(chunkSize, n - uint64_t(k) * chunkSize); }
+    uint64_t chunkOffset(size_t k) const { return uint64_t(k) * chunkSize; }   // 第 k 块在原文中的起点
+
+    // 解码第 k 块到 out（至少 chunkLength(k) 字节）
+    void decode(size_t k, uint8_t* out) const {
+        if (k >= chunks) throw std::out_of_range("chunk index out of range");
+        uint64_t lo = HuffCodec::getLE(index + 8 * k, 8), hi = HuffCodec::getLE(index + 8 * (k + 1), 8);
+        if (lo > hi || hi > size - dataStart) throw std::runtime_error("invalid chunk index");
+        HuffCodec::decodeSymbols(table.data(), in, dataStart + hi, dataStart + lo, out, chunkLength(k));
+    }
+    std::vector<uint8_t> decode(size_t k) const {
+        std::vector<uint8_t> out(chunkLength(k));
+        decode(k, out.data());
+        return out;
+    }
+};
+
+inline std::vector<uint8_t> HuffCodec::decodeChunked(const uint8_t* in, size_t size, unsigned threads) {
+    HuffChunkReader reader(in, size);
+    std::vector<uint8_t> out(reader.length());
+    huffParallelFor(reader.chunkCount(), threads, [&](size_t k) { reader.decode(k, out.data() + reader.chunkOffset(k)); });
+    return out;
+}
+#endif // HUFF_CODEC_H
@@ -0,0 +1,319 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// 压缩位图（Roaring 思路）：按 id 的高 16 位分块，每块 2^16 位，依密度选用三种容器：
+//   数组容器：有序 uint16 数组，元素不超过 4096 个；
+//   位图容器：1024 个 64 位字；
+//   行程容器：(起点, 长度 - 1) 序列，由 runOptimize() 对连续区间生成。
+// 内存随置位数而非最大 id 增长；接口与 Bitmap 一致（set / clear / test / size）。
+class RoaringBitmap {
+private:
+    enum Type : uint8_t { ARRAY = 0, BITSET = 1, RUN = 2 };
+    static const int ARRAY_MAX = 4096;          // 数组容器的最大元素数
+    static const int BITSET_WORDS = 1024;
+
+    struct Container {
+        Type type = ARRAY;
+        int card = 0;                           // 元素个数
+        std::vector<uint16_t> array;            // ARRAY：有序元素；RUN：交替存放起点与长度 - 1
+        std::vector<uint64_t> bits;             // BITSET
+
+        bool test(uint16_t v) const {
+            switch (type) {
+            case ARRAY: return std::binary_search(array.begin(), array.end(), v);
+            case BITSET: return bits[v >> 6] >> (v & 63) & 1;
+            default: {
+                for (size_t i = 0; i < array.size(); i += 2) {
+                    if (v < array[i]) return false;
+                    if (v - array[i] <= array[i + 1]) return true;
+                }
+                return false;
+            }
+            }
+        }
+        void toBitset() {
+            std::vector<uint64_t> b(BITSET_WORDS, 0);
+            forEach([&](uint16_t v) { b[v >> 6] |= uint64_t(1) << (v & 63); });
+            bits.swap(b);
+            array.clear(); array.shrink_to_fit();
+            type = BITSET;
+        }
+        void toArray() {
+            std::vector<uint16_t> a;
+            a.reserve(card);
+            forEach([&](uint16_t v) { a.push_back(v); });
+            array.swap(a);
+            bits.clear(); bits.shrink_to_fit();
+            type = ARRAY;
+        }
+        void normalize() {                      // 按元素个数选择数组或位图容器
+            if (type == RUN) { card > ARRAY_MAX ? toBitset() : toArray(); return; }
+            if (type == BITSET && card <= ARRAY_MAX) toArray();
+            else if (type == ARRAY && card > ARRAY_MAX) toBitset();
+        }
+        template <typename F>
+        void forEach(F f) const {
+            switch (type) {
+            case ARRAY:
+                for (uint16_t v : array) f(v);
+                break;
+            case BITSET:
+                for (int i = 0; i < BITSET_WORDS; i++)
+                    for (uint64_t w = bits[i]; w; w &= w - 1) f(static_cast<uint16_t>((i << 6) + __builtin_ctzll(w)));
+                break;
+            default:
+                for (size_t i = 0; i < array.size(); i += 2)
+                    for (uint32_t v = array[i]; v <= uint32_t(array[i]) + array[i + 1]; v++) f(static_cast<uint16_t>(v));
+            }
+        }
+        bool set(uint16_t v) {                  // 返回是否新增
+            if (type == RUN) normalize();
+            if (type == BITSET) {
+                uint64_t& w = bits[v >> 6];
+                uint64_t bit = uint64_t(1) << (v & 63);
+                if (w & bit) return false;
+                w |= bit; card++;
+                return true;
+            }
+            auto it = std::lower_bound(array.begin(), array.end(), v);
+            if (it != array.end() && *it == v) return false;
+            array.insert(it, v); card++;
+            if (card > ARRAY_MAX) toBitset();
+            return true;
+        }
+        bool clear(uint16_t v) {                // 返回是否删除
+            if (type == RUN) normalize();
+            if (type == BITSET) {
+                uint64_t& w = bits[v >> 6];
+                uint64_t bit = uint64_t(1) << (v & 63);
+                if (!(w & bit)) return false;
+                w &= ~bit; card--;
+                if (card <= ARRAY_MAX) toArray();
+                return true;
+            }
+            auto it = std::lower_bound(array.begin(), array.end(), v);
+            if (it == array.end() || *it != v) return false;
+            array.erase(it); card--;
+            return true;
+        }
+        void runOptimize() {                    // 行程编码更省空间时转为行程容器
+            std::vector<uint16_t> runs;
+            int start = -2, last = -2;
+            forEach([&](uint16_t v) {
+                if (v != last + 1) {
+                    if (start >= 0) { runs.push_back(static_cast<uint16_t>(start)); runs.push_back(static_cast<uint16_t>(last - start)); }
+                    start = v;
+                }
+                last = v;
+            });
+            if (start >= 0) { runs.push_back(static_cast<uint16_t>(start)); runs.push_back(static_cast<uint16_t>(last - start)); }
+            size_t current = (type == BITSET) ? BITSET_WORDS * 8 : array.size() * 2;
+            if (runs.size() * 2 < current) {
+                array.swap(runs);
+                bits.clear(); bits.shrink_to_fit();
+                type = RUN;
+            }
+        }
+        size_t bytes() const { return array.capacity() * 2 + bits.capacity() * 8 + sizeof(Container); }
+    };
+
+    // 容器级集合运算；OP 为 0 与、1 或、2 异或、3 差
+    template <int OP>
+    static Container combine(const Container& a, const Container& b) {
+        Container r;
+        if (a.type == ARRAY && b.type == ARRAY) {
+            std::vector<uint16_t>& out = r.array;
+            out.reserve(OP == 0 ? std::min(a.card, b.card) : a.card + b.card);
+            auto ai = a.array.begin(), ae = a.array.end(), bi = b.array.begin(), be = b.array.end();
+            if (OP == 0) std::set_intersection(ai, ae, bi, be, std::back_inserter(out));
+            else if (OP == 1) std::set_union(ai, ae, bi, be, std::back_inserter(out));
+            else if (OP == 2) std::set_symmetric_difference(ai, ae, bi, be, std::back_inserter(out));
+            else std::set_difference(ai, ae, bi, be, std::back_inserter(out));
+            r.card = static_cast<int>(out.size());
+            r.normalize();
+            return r;
+        }
+        Container x = a, y = b;                 // 至少一方是位图或行程：统一按位图逐字运算
+        if (x.type != BITSET) x.toBitset();
+        if (y.type != BITSET) y.toBitset();
+        r.type = BITSET;
+        r.bits.resize(BITSET_WORDS);
+        int card = 0;
+        for (int i = 0; i < BITSET_WORDS; i++) {
+            uint64_t w = OP == 0 ? (x.bits[i] & y.bits[i]) : OP == 1 ? (x.bits[i] | y.bits[i])
+                       : OP == 2 ? (x.bits[i] ^ y.bits[i]) : (x.bits[i] & ~y.bits[i]);
+            r.bits[i] = w;
+            card += __builtin_popcountll(w);
+        }
+        r.card = card;
+        r.normalize();
+        return r;
+    }
+
+    template <int OP>
+    static RoaringBitmap combine(const RoaringBitmap& a, const RoaringBitmap& b) {
+        RoaringBitmap r;
+        size_t i = 0, j = 0;
+        while (i < a.keys.size() || j < b.keys.size()) {
+            bool useA = i < a.keys.size(), useB = j < b.keys.size();
+            if (useA && useB) {
+                if (a.keys[i] < b.keys[j]) useB = false;
+                else if (b.keys[j] < a.keys[i]) useA = false;
+            }
+            if (useA && useB) {
+                Container c = combine<OP>(a.containers[i], b.containers[j]);
+                if (c.card) { r.keys.push_back(a.keys[i]); r.containers.push_back(std::move(c)); }
+                i++; j++;
+            }
+            else if (useA) {                    // 只有 a 有该块：与运算丢弃，其余保留
+                if (OP != 0) { r.keys.push_back(a.keys[i]); r.containers.push_back(a.containers[i]); }
+                i++;
+            }
+            else {                              // 只有 b 有该块：或、异或保留
+                if (OP == 1 || OP == 2) { r.keys.push_back(b.keys[j]); r.containers.push_back(b.containers[j]); }
+                j++;
+            }
+        }
+        r.recount();
+        return r;
+    }
+
+    std::vector<uint16_t> keys;                 // 各容器对应的高 16 位，升序
+    std::vector<Container> containers;
+    int _sz = 0;
+
+    void recount() {
+        _sz = 0;
+        for (const auto& c : containers) _sz += c.card;
+    }
+    static bool valid(const Container& c) {     // 反序列化得到的容器是否自洽
+        uint32_t count = 0;
+        switch (c.type) {
+        case ARRAY:
+            for (size_t i = 1; i < c.array.size(); i++) if (c.array[i] <= c.array[i - 1]) return false;
+            count = static_cast<uint32_t>(c.array.size());
+            break;
+        case BITSET:
+            for (uint64_t w : c.bits) count += __builtin_popcountll(w);
+            break;
+        default:
+            if (c.array.size() % 2 != 0) return false;          // (起点, 长度 - 1) 成对出现
+            for (size_t i = 0; i < c.array.size(); i += 2) {
+                uint32_t start = c.array[i], end = start + c.array[i + 1];
+                if (end > 0xFFFF || (i > 0 && start <= uint32_t(c.array[i - 2]) + c.array[i - 1])) return false;
+                count += end - start + 1;
+            }
+        }
+        return count == static_cast<uint32_t>(c.card);
+    }
+    int find(uint16_t key) const {
+        auto it = std::lower_bound(keys.begin(), keys.end(), key);
+        return (it != keys.end() && *it == key) ? static_cast<int>(it - keys.begin()) : -1;
+    }
+
+public:
+    void set(int k) {
+        uint16_t hi = static_cast<uint16_t>(uint32_t(k) >> 16);
+        auto it = std::lower_bound(keys.begin(), keys.end(), hi);
+        size_t i = it - keys.begin();
+        if (it == keys.end() || *it != hi) {
+            keys.insert(it, hi);
+            containers.insert(containers.begin() + i, Container());
+        }
+        if (containers[i].set(static_cast<uint16_t>(k))) _sz++;
+    }
+    void clear(int k) {
+        int i = find(static_cast<uint16_t>(uint32_t(k) >> 16));
+        if (i < 0 || !containers[i].clear(static_cast<uint16_t>(k))) return;
+        _sz--;
+        if (!containers[i].card) {
+            keys.erase(keys.begin() + i);
+            containers.erase(containers.begin() + i);
+        }
+    }
+    bool test(int k) const {
+        int i = find(static_cast<uint16_t>(uint32_t(k) >> 16));
+        return i >= 0 && containers[i].test(static_cast<uint16_t>(k));
+    }
+    int size() const { return _sz; }            // 置位数
+
+    void runOptimize() { for (auto& c : containers) c.runOptimize(); }
+    size_t bytes() const {                      // 估算占用的内存字节数
+        size_t b = sizeof(*this) + keys.capacity() * 2;
+        for (const auto& c : containers) b += c.bytes();
+        return b;
+    }
+
+    template <typename F>
+    void forEach(F f) const {                   // 按升序访问每个置位
+        for (size_t i = 0; i < keys.size(); i++) {
+            uint32_t base = uint32_t(keys[i]) << 16;
+            containers[i].forEach([&](uint16_t v) { f(static_cast<int>(base | v)); });
+        }
+    }
+
+    friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b) { return combine<0>(a, b); }
+    friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b) { return combine<1>(a, b); }
+    friend RoaringBitmap operator^(const RoaringBitmap& a, const RoaringBitmap& b) { return combine<2>(a, b); }
+    RoaringBitmap andNot(const RoaringBitmap& b) const { return combine<3>(*this, b); }
+
+    // 序列化格式（小端）："RBM1" | 容器数 u32 | 每个容器：键 u16、类型 u8、元素数 u32、数据长度 u32、数据
+    void write(std::ostream& os) const {
+        os.write("RBM1", 4);
+        uint32_t n = static_cast<uint32_t>(keys.size());
+        os.write(reinterpret_cast<const char*>(&n), 4);
+        for (size_t i = 0; i < keys.size(); i++) {
+            const Container& c = containers[i];
+            uint8_t type = c.type;
+            uint32_t card = c.card;
+            uint32_t len = static_cast<uint32_t>(c.type == BITSET ? c.bits.size() * 8 : c.array.size() * 2);
+            os.write(reinterpret_cast<const char*>(&keys[i]), 2);
+            os.write(reinterpret_cast<const char*>(&type), 1);
+            os.write(reinterpret_cast<const char*>(&card), 4);
+            os.write(reinterpret_cast<const char*>(&len), 4);
+            if (c.type == BITSET) os.write(reinterpret_cast<const char*>(c.bits.data()), len);
+            else os.write(reinterpret_cast<const char*>(c.array.data()), len);
+        }
+    }
+    // 格式错误时返回 false，位图置空。校验：键严格递增；数据长度为偶数且不超过容器上限；
+    // 数组容器元素数与长度一致且严格递增；行程容器成对、有序不重叠、不越过 65535；元素数与内容一致
+    bool read(std::istream& is) {
+        keys.clear(); containers.clear(); _sz = 0;
+        char magic[4];
+        uint32_t n;
+        if (!is.read(magic, 4) || memcmp(magic, "RBM1", 4) != 0) return false;
+        if (!is.read(reinterpret_cast<char*>(&n), 4) || n > 65536) return false;
+        auto fail = [&]() { keys.clear(); containers.clear(); return false; };
+        for (uint32_t i = 0; i < n; i++) {
+            uint16_t key;
+            uint8_t type;
+            uint32_t card, len;
+            is.read(reinterpret_cast<char*>(&key), 2);
+            is.read(reinterpret_cast<char*>(&type), 1);
+            is.read(reinterpret_cast<char*>(&card), 4);
+            is.read(reinterpret_cast<char*>(&len), 4);
+            if (!is || type > RUN || (!keys.empty() && key <= keys.back())) return fail();
+            if (type == BITSET ? len != BITSET_WORDS * 8 : len % 2 != 0 || len > (type == ARRAY ? ARRAY_MAX * 2 : BITSET_WORDS * 8))
+                return fail();
+            Container c;
+            c.type = static_cast<Type>(type);
+            c.card = static_cast<int>(card);
+            if (c.type == BITSET) { c.bits.resize(BITSET_WORDS); is.read(reinterpret_cast<char*>(c.bits.data()), len); }
+            else { c.array.resize(len / 2); is.read(reinterpret_cast<char*>(c.array.data()), len); }
+            if (!is || !valid(c)) return fail();
+            keys.push_back(key);
+            containers.push_back(std::move(c));
+        }
+        recount();
+        return true;
+    }
+};
+#endif // ROARING_BITMAP_H
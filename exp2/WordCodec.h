@@ -0,0 +1,372 @@
+#ifndef WORD_CODEC_H
+#define WORD_CODEC_H
+
+#include <cmath>
+#include <memory>
+#include "HuffCodec.h"
+
+// 词级/混合哈夫曼编码：文本切分为单词（连续 ASCII 字母）与单个字节，
+// 按估算收益选词进入词典（拼写节省的位数超过词典条目的开销），其余单词按字节拼写；
+// 符号表为 256 个字节加词典中的单词，对符号编号做规范哈夫曼编码。
+//
+// 两种模式：
+//   STATIC   两遍扫描，码长写入文件头
+//   ADAPTIVE 码表不写入文件，编解码双方从均匀码出发，每隔一段符号按已见频率（每次重建时减半，跟踪统计漂移）
+//            同步重建码表，间隔从 1024 个符号倍增到 65536
+//
+// 格式："HUFW" | 模式 u8 | 原始长度 u64 | 符号数 u64 | 词数 u32 | 各词 (长度 u8 + 字节) | [STATIC：各符号 5 位码长] | 位流
+
+// 单词词典：开放定址（线性探测）哈希表，单词连续存放在 chars 中，以编号引用
+class WordDictionary {
+private:
+    std::string chars;
+    std::vector<uint32_t> offsets = { 0 };      // 第 i 个词为 chars[offsets[i], offsets[i + 1])
+    std::vector<uint64_t> hashes;
+    std::vector<int32_t> slots;                 // 词编号，-1 为空
+    size_t mask = 0;
+
+    void grow() {
+        std::vector<int32_t>(slots.empty() ? 1024 : slots.size() * 2, -1).swap(slots);
+        mask = slots.size() - 1;
+        for (size_t id = 0; id < hashes.size(); id++) {
+            size_t i = hashes[id] & mask;
+            while (slots[i] >= 0) i = (i + 1) & mask;
+            slots[i] = static_cast<int32_t>(id);
+        }
+    }
+
+public:
+    static uint64_t hash(const char* p, int n) {  // FNV-1a
+        uint64_t h = 1469598103934665603ull;
+        for (int i = 0; i < n; i++) h = (h ^ static_cast<uint8_t>(p[i])) * 1099511628211ull;
+        return h ^ (h >> 29);
+    }
+
+    int size() const { return static_cast<int>(hashes.size()); }
+    const char* word(int id) const { return chars.data() + offsets[id]; }
+    int length(int id) const { return static_cast<int>(offsets[id + 1] - offsets[id]); }
+
+    int find(const char* p, int n) const {        // 不存在返回 -1
+        if (slots.empty()) return -1;
+        uint64_t h = hash(p, n);
+        for (size_t i = h & mask; slots[i] >= 0; i = (i + 1) & mask) {
+            int id = slots[i];
+            if (hashes[id] == h && length(id) == n && memcmp(word(id), p, n) == 0) return id;
+        }
+        return -1;
+    }
+
+    int insert(const char* p, int n) {            // 返回已有或新分配的编号
+        if (2 * (hashes.size() + 1) > slots.size()) grow();
+        uint64_t h = hash(p, n);
+        size_t i = h & mask;
+        for (; slots[i] >= 0; i = (i + 1) & mask) {
+            int id = slots[i];
+            if (hashes[id] == h && length(id) == n && memcmp(word(id), p, n) == 0) return id;
+        }
+        int id = size();
+        slots[i] = id;
+        hashes.push_back(h);
+        chars.append(p, n);
+        offsets.push_back(static_cast<uint32_t>(chars.size()));
+        return id;
+    }
+};
+
+// 任意大小字母表上的限长规范哈夫曼码，解码用两级查找表；重建时复用内部缓冲，不再分配
+class SymbolCode {
+public:
+    static const int MAX_CODE_LEN = 24;
+    static const int ROOT_BITS = 12;
+
+    std::vector<uint32_t> code;                 // 码字（低位先发送）
+    std::vector<uint8_t> len;                   // 码长，0 表示未出现
+
+    // 由频率构造码长、码字与解码表
+    void build(const std::vector<uint64_t>& freq) {
+        int n = static_cast<int>(freq.size());
+        if (n > (1 << MAX_CODE_LEN)) throw std::invalid_argument("alphabet too large");
+        len.assign(n, 0);
+        order.clear();
+        for (int s = 0; s < n; s++) if (freq[s]) order.push_back(s);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return freq[a] != freq[b] ? freq[a] < freq[b] : a < b; });
+        int m = static_cast<int>(order.size());
+        scratch.resize(m);
+        for (int i = 0; i < m; i++) scratch[i] = freq[order[i]];
+        huffmanLengthsInPlace(scratch.data(), m);
+        bool over = false;
+        for (int i = 0; i < m; i++) {
+            len[order[i]] = static_cast<uint8_t>(std::min<uint64_t>(std::max<uint64_t>(scratch[i], 1), 255));
+            over = over || len[order[i]] > MAX_CODE_LEN;
+        }
+        if (over) limitLengths();
+        assignCodes();
+    }
+
+    void put(BitWriter& w, uint32_t s) const { w.put(code[s], len[s]); }
+
+    // 解码一个符号；调用前保证缓冲区内有至少 MAX_CODE_LEN 位（或已到输入末尾）
+    uint32_t get(BitReader& r) const {
+        uint64_t bits = r.peek();
+        Entry e = table[bits & ((1 << ROOT_BITS) - 1)];
+        if (e.sub) e = table[e.symbol + ((bits >> ROOT_BITS) & ((uint64_t(1) << e.sub) - 1))];
+        if (!e.len) throw std::runtime_error("invalid Huffman code");
+        if (e.len > r.available()) throw std::runtime_error("truncated Huffman stream");
+        r.consume(e.len);
+        return e.symbol;
+    }
+
+    void writeLengths(BitWriter& w) const {
+        for (uint8_t l : len) w.put(l, 5);
+    }
+    void readLengths(BitReader& r, int n) {
+        len.resize(n);
+        uint64_t kraft = 0;
+        for (int s = 0; s < n; s++) {
+            len[s] = static_cast<uint8_t>(r.get(5));
+            if (len[s] > MAX_CODE_LEN) throw std::runtime_error("invalid Huffman code length");
+            if (len[s]) kraft += uint64_t(1) << (MAX_CODE_LEN - len[s]);
+        }
+        if (kraft > (uint64_t(1) << MAX_CODE_LEN)) throw std::runtime_error("invalid Huffman code table");
+        assignCodes();
+    }
+
+private:
+    struct Entry {                              // 一级表中 sub > 0 表示跳转到从 symbol 开始、索引 sub 位的二级表
+        uint32_t symbol;
+        uint8_t len;
+        uint8_t sub;
+    };
+    std::vector<Entry> table;
+    std::vector<int> order;
+    std::vector<uint64_t> scratch;
+
+    // 截断到 MAX_CODE_LEN 并恢复 Kraft 不等式，做法同 HuffCodec::limitLengths（order 为频率升序）
+    void limitLengths() {
+        const int64_t full = int64_t(1) << MAX_CODE_LEN;
+        int m = static_cast<int>(order.size());
+        int64_t kraft = 0;
+        for (int s : order) {
+            if (len[s] > MAX_CODE_LEN) len[s] = MAX_CODE_LEN;
+            kraft += full >> len[s];
+        }
+        for (int i = 0; kraft > full; i = i + 1 < m ? i + 1 : 0) {
+            int s = order[i];
+            if (len[s] < MAX_CODE_LEN) {
+                len[s]++;
+                kraft -= full >> len[s];
+            }
+        }
+        for (int i = m - 1; i >= 0; i--) {
+            int s = order[i];
+            while (len[s] > 1 && kraft + (full >> len[s]) <= full) {
+                kraft += full >> len[s];
+                len[s]--;
+            }
+        }
+    }
+
+    // 规范码字：按码长计数求各长度的首码，同长度按符号号递增，线性时间；随后建两级解码表
+    void assignCodes() {
+        int n = static_cast<int>(len.size());
+        uint32_t count[MAX_CODE_LEN + 1] = {}, next[MAX_CODE_LEN + 1] = {};
+        for (uint8_t l : len) count[l]++;
+        count[0] = 0;
+        for (int l = 1; l <= MAX_CODE_LEN; l++) next[l] = (next[l - 1] + count[l - 1]) << 1;
+        code.assign(n, 0);
+        for (int s = 0; s < n; s++) {
+            int l = len[s];
+            if (!l) continue;
+            uint32_t c = next[l]++, rev = 0;
+            for (int b = 0; b < l; b++) rev |= ((c >> b) & 1) << (l - 1 - b);
+            code[s] = rev;
+        }
+
+        const int rootSize = 1 << ROOT_BITS, rootMask = rootSize - 1;
+        int subBits[1 << ROOT_BITS] = {};
+        for (int s = 0; s < n; s++) {
+            if (len[s] > ROOT_BITS) {
+                int& b = subBits[code[s] & rootMask];
+                b = std::max(b, len[s] - ROOT_BITS);
+            }
+        }
+        table.assign(rootSize, Entry{ 0, 0, 0 });
+        for (int p = 0; p < rootSize; p++) {
+            if (!subBits[p]) continue;
+            table[p] = Entry{ static_cast<uint32_t>(table.size()), 0, static_cast<uint8_t>(subBits[p]) };
+            table.resize(table.size() + (size_t(1) << subBits[p]), Entry{ 0, 0, 0 });
+        }
+        for (int s = 0; s < n; s++) {
+            int l = len[s];
+            if (!l) continue;
+            Entry e{ static_cast<uint32_t>(s), static_cast<uint8_t>(l), 0 };
+            if (l <= ROOT_BITS) {
+                for (uint32_t k = code[s]; k < uint32_t(rootSize); k += uint32_t(1) << l) table[k] = e;
+            } else {
+                const Entry link = table[code[s] & rootMask];
+                for (uint32_t k = code[s] >> ROOT_BITS; k < (uint32_t(1) << link.sub); k += uint32_t(1) << (l - ROOT_BITS))
+                    table[link.symbol + k] = e;
+            }
+        }
+    }
+};
+
+class WordCodec {
+public:
+    enum Mode { STATIC = 0, ADAPTIVE = 1 };
+    static const int MIN_WORD_COUNT = 2;        // 进入词典的最少出现次数
+    static constexpr double BITS_PER_LETTER = 4.5;  // 估算收益时按字节拼写每个字母的位数
+    static const int MAX_WORD_LEN = 255;
+
+    static std::vector<uint8_t> encode(const uint8_t* data, size_t n, Mode mode = STATIC) {
+        // 第一遍：统计所有长度不小于 2 的单词
+        WordDictionary all;
+        std::vector<uint32_t> counts;
+        forEachToken(data, n, [&](size_t pos, int wordLen) {
+            if (wordLen < 2) return;
+            int id = all.insert(reinterpret_cast<const char*>(data + pos), wordLen);
+            if (id == static_cast<int>(counts.size())) counts.push_back(0);
+            counts[id]++;
+        });
+        // 选出收益为正的词，符号号为 256 + 词号：每次出现节省 拼写位数 - 词码长（约 log2(总词数 / 出现次数)），
+        // 词典条目开销为 8 × (长度 + 1) 位加码长
+        WordDictionary dict;
+        std::vector<int32_t> symbolOf(all.size(), -1);
+        double total = 1;
+        for (uint32_t c : counts) total += c;
+        for (int id = 0; id < all.size(); id++) {
+            if (counts[id] < MIN_WORD_COUNT) continue;
+            int l = all.length(id);
+            double gain = counts[id] * (BITS_PER_LETTER * l - std::log2(total / counts[id]));
+            if (gain > 8.0 * (l + 1) + 5) symbolOf[id] = 256 + dict.insert(all.word(id), l);
+        }
+        // 第二遍：切分为符号序列
+        std::vector<uint32_t> symbols;
+        symbols.reserve(n / 3 + 16);
+        forEachToken(data, n, [&](size_t pos, int wordLen) {
+            int sym = wordLen >= 2 ? symbolOf[all.find(reinterpret_cast<const char*>(data + pos), wordLen)] : -1;
+            if (sym >= 0) symbols.push_back(static_cast<uint32_t>(sym));
+            else for (int i = 0; i < std::max(wordLen, 1); i++) symbols.push_back(data[pos + i]);
+        });
+
+        int alphabet = 256 + dict.size();
+        std::vector<uint8_t> out;
+        out.insert(out.end(), { 'H', 'U', 'F', 'W', static_cast<uint8_t>(mode) });
+        for (int b = 0; b < 8; b++) out.push_back(static_cast<uint8_t>(uint64_t(n) >> (8 * b)));
+        for (int b = 0; b < 8; b++) out.push_back(static_cast<uint8_t>(uint64_t(symbols.size()) >> (8 * b)));
+        for (int b = 0; b < 4; b++) out.push_back(static_cast<uint8_t>(dict.size() >> (8 * b)));
+        for (int id = 0; id < dict.size(); id++) {
+            out.push_back(static_cast<uint8_t>(dict.length(id)));
+            out.insert(out.end(), dict.word(id), dict.word(id) + dict.length(id));
+        }
+
+        SymbolCode sc;
+        std::vector<uint64_t> freq(alphabet, 0);
+        BitWriter w(out);
+        if (mode == STATIC) {
+            for (uint32_t s : symbols) freq[s]++;
+            sc.build(freq);
+            sc.writeLengths(w);
+            for (uint32_t s : symbols) sc.put(w, s);
+        } else {
+            Adaptive model(freq, sc);
+            for (uint32_t s : symbols) {
+                sc.put(w, s);
+                model.update(s);
+            }
+        }
+        w.finish();
+        return out;
+    }
+
+    static std::vector<uint8_t> decode(const std::vector<uint8_t>& in) { return decode(in.data(), in.size()); }
+    static std::vector<uint8_t> decode(const uint8_t* in, size_t size) {
+        if (size < 25 || memcmp(in, "HUFW", 4) != 0 || in[4] > ADAPTIVE) throw std::runtime_error("invalid word Huffman stream");
+        Mode mode = static_cast<Mode>(in[4]);
+        uint64_t n = 0, tokens = 0;
+        uint32_t words = 0;
+        for (int b = 0; b < 8; b++) n |= uint64_t(in[5 + b]) << (8 * b);
+        for (int b = 0; b < 8; b++) tokens |= uint64_t(in[13 + b]) << (8 * b);
+        for (int b = 0; b < 4; b++) words |= uint32_t(in[21 + b]) << (8 * b);
+        if (tokens > n || words > (1u << SymbolCode::MAX_CODE_LEN) - 256) throw std::runtime_error("invalid word Huffman stream");
+        size_t pos = 25;
+        std::vector<uint32_t> offsets(words + 1, 0);  // 词典直接引用输入中的字节
+        std::vector<uint8_t> lengths(words);
+        for (uint32_t id = 0; id < words; id++) {
+            if (pos >= size || size - pos - 1 < in[pos]) throw std::runtime_error("truncated word Huffman stream");
+            lengths[id] = in[pos];
+            offsets[id] = static_cast<uint32_t>(pos + 1);
+            pos += 1 + in[pos];
+        }
+
+        // 每个记号至少 1 比特、至多展开为 255 字节：先用剩余数据量约束头部声明的长度，再分配输出
+        if (tokens > 8 * uint64_t(size - pos) || n > tokens * 255) throw std::runtime_error("invalid word Huffman stream");
+        int alphabet = 256 + static_cast<int>(words);
+        SymbolCode sc;
+        std::vector<uint64_t> freq(alphabet, 0);
+        BitReader r(in, size, pos);
+        std::unique_ptr<Adaptive> model;
+        if (mode == STATIC) sc.readLengths(r, alphabet);
+        else model.reset(new Adaptive(freq, sc));
+        std::vector<uint8_t> out(n);
+        size_t o = 0;
+        for (uint64_t t = 0; t < tokens; t++) {
+            if (r.available() < SymbolCode::MAX_CODE_LEN) r.refill();
+            uint32_t s = sc.get(r);
+            if (model) model->update(s);
+            if (s < 256) {
+                if (o >= n) throw std::runtime_error("corrupt word Huffman stream");
+                out[o++] = static_cast<uint8_t>(s);
+            } else {
+                uint32_t id = s - 256;
+                if (n - o < lengths[id]) throw std::runtime_error("corrupt word Huffman stream");
+                memcpy(&out[o], in + offsets[id], lengths[id]);
+                o += lengths[id];
+            }
+        }
+        if (o != n) throw std::runtime_error("corrupt word Huffman stream");
+        return out;
+    }
+
+private:
+    // 自适应模型：编解码双方以相同顺序调用 update，码表在同一位置重建
+    class Adaptive {
+    private:
+        std::vector<uint64_t>& freq;
+        SymbolCode& sc;
+        uint64_t seen = 0, nextRebuild = 1024, interval = 1024;
+
+        void rebuild() {                        // 频率加一保证每个符号都有码字
+            for (auto& f : freq) f += 1;
+            sc.build(freq);
+            for (auto& f : freq) f -= 1;
+        }
+
+    public:
+        Adaptive(std::vector<uint64_t>& f, SymbolCode& s) : freq(f), sc(s) { rebuild(); }
+        void update(uint32_t s) {
+            freq[s]++;
+            if (++seen < nextRebuild) return;
+            rebuild();
+            for (auto& f : freq) f >>= 1;       // 衰减旧统计
+            interval = std::min<uint64_t>(interval * 2, 65536);
+            nextRebuild = seen + interval;
+        }
+    };
+
+    static bool isLetter(uint8_t c) { return static_cast<uint8_t>((c | 32) - 'a') < 26; }
+
+    // 依次回调每个记号：单词（连续字母，超长时按 MAX_WORD_LEN 截断分段）给出 (起点, 长度)，其他字节给出 (位置, 0)
+    template <typename F>
+    static void forEachToken(const uint8_t* data, size_t n, F f) {
+        size_t i = 0;
+        while (i < n) {
+            if (!isLetter(data[i])) { f(i++, 0); continue; }
+            size_t j = i + 1;
+            while (j < n && j - i < MAX_WORD_LEN && isLetter(data[j])) j++;
+            f(i, static_cast<int>(j - i));
+            i = j;
+        }
+    }
+};
+#endif // WORD_CODEC_H
@@ -1,20 +1,22 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <unordered_map>
 #include <vector>
-#include <queue>
 #include <string>
 #include <algorithm>
+#include <cstdlib>
+#include "HuffCodec.h"
+#include "WordCodec.h"
+#include "../Benchmark.h"
 
-// 定义哈夫曼树的节点
+// 定义哈夫曼树的节点，孩子以下标表示，-1 为空
 struct HuffNode {
     char ch;
-    int freq;
-    HuffNode* left;
-    HuffNode* right;
+    uint64_t freq;
+    int left;
+    int right;
 
-    HuffNode(char c, int f) : ch(c), freq(f), left(nullptr), right(nullptr) {}
+    HuffNode(char c, uint64_t f, int l = -1, int r = -1) : ch(c), freq(f), left(l), right(r) {}
 
     // 用于优先队列的比较
     bool operator>(const HuffNode& other) const {
@@ -22,68 +24,88 @@ struct HuffNode {
     }
 };
 
-// 哈夫曼树类
+// 哈夫曼树类：节点连续存放在 nodes 中，随树一起释放
 class HuffTree {
 public:
-    HuffNode* root;
+    std::vector<HuffNode> nodes;
+    int root;
 
-    HuffTree(std::unordered_map<char, int>& freq) {
-        // 创建优先队列
-        std::priority_queue<HuffNode*, std::vector<HuffNode*>, std::greater<HuffNode*>> pq;
+    // 双队列线性构造：叶子按频率升序排在 nodes 前部，新建的内部节点频率单调不减，
+    // 依次追加在后部，因此两段各自有序，每次从两段队首取较小者即可，无需堆
+    HuffTree(std::unordered_map<char, uint64_t>& freq) : root(-1) {
+        int n = static_cast<int>(freq.size());
+        nodes.reserve(2 * n);
+        for (auto& pair : freq) nodes.emplace_back(pair.first, pair.second);
+        std::sort(nodes.begin(), nodes.end(), [](const HuffNode& a, const HuffNode& b) {
+            return a.freq != b.freq ? a.freq < b.freq : a.ch < b.ch;
+        });
+        if (n == 0) return;
 
-        // 将所有字符及其频率加入优先队列
-        for (auto& pair : freq) {
-            pq.push(new HuffNode(pair.first, pair.second));
+        int leaf = 0, inner = n;                    // 两个队列的队首
+        auto takeMin = [&]() {                      // 频率相同时优先取叶子
+            if (inner >= static_cast<int>(nodes.size()) || (leaf < n && !(nodes[leaf] > nodes[inner]))) return leaf++;
+            return inner++;
+        };
+        for (int k = 1; k < n; k++) {
+            int left = takeMin();
+            int right = takeMin();
+            nodes.emplace_back('\0', nodes[left].freq + nodes[right].freq, left, right);
         }
-
-        // 构造哈夫曼树
-        while (pq.size() > 1) {
-            HuffNode* left = pq.top(); pq.pop();
-            HuffNode* right = pq.top(); pq.pop();
-
-            HuffNode* sum = new HuffNode('\0', left->freq + right->freq);
-            sum->left = left;
-            sum->right = right;
-
-            pq.push(sum);
-        }
-
-        root = pq.top();
+        root = static_cast<int>(nodes.size()) - 1;
     }
 
-    // 生成哈夫曼编码
-    void generateCodes(HuffNode* node, const std::string& code, std::unordered_map<char, std::string>& huffCode) {
-        if (!node) return;
-        if (node->left == nullptr && node->right == nullptr) {
-            huffCode[node->ch] = code;
+    // 生成规范哈夫曼编码：树只用来确定码长，码字按 (码长, 字符) 顺序依次分配
+    void generateCodes(std::unordered_map<char, std::string>& huffCode) const {
+        if (root < 0) return;
+        std::vector<std::pair<char, int>> lengths;      // (字符, 码长)
+        std::vector<std::pair<int, int>> stack = { { root, 0 } };
+        while (!stack.empty()) {
+            auto [v, depth] = stack.back();
+            stack.pop_back();
+            if (nodes[v].left < 0) {
+                lengths.push_back({ nodes[v].ch, std::max(depth, 1) });   // 只有一个字符时码长取 1
+                continue;
+            }
+            stack.push_back({ nodes[v].left, depth + 1 });
+            stack.push_back({ nodes[v].right, depth + 1 });
+        }
+        std::sort(lengths.begin(), lengths.end(), [](const std::pair<char, int>& a, const std::pair<char, int>& b) {
+            return a.second != b.second ? a.second < b.second : a.first < b.first;
+        });
+        uint64_t next = 0;
+        int prevLen = lengths[0].second;
+        for (auto& [ch, len] : lengths) {
+            next <<= len - prevLen;
+            prevLen = len;
+            std::string& code = huffCode[ch];
+            code.assign(len, '0');
+            for (int b = 0; b < len; b++) if (next >> (len - 1 - b) & 1) code[b] = '1';
+            next++;
         }
-        generateCodes(node->left, code + "0", huffCode);
-        generateCodes(node->right, code + "1", huffCode);
     }
 };
 
 // 哈夫曼编码类
 class HuffmanCoding {
 public:
-    std::unordered_map<char, int> frequencies;
+    std::unordered_map<char, uint64_t> frequencies;
     std::unordered_map<char, std::string> huffCode;
 
     // 构造函数，根据文本频率统计
+    // 文件经 mmap 映射后多线程统计 256 项字节直方图，再归并出字母频率，不复制文件内容
     HuffmanCoding(const std::string& filename) {
-        std::ifstream file(filename);
-        std::stringstream buffer;
-        buffer << file.rdbuf();  // 读取文件内容
-
-        std::string text = buffer.str();
-        for (char ch : text) {
-            if (isalpha(ch)) frequencies[tolower(ch)]++; // 统计字符频率
+        MappedFile file(filename.c_str());
+        uint64_t counts[256] = {};
+        parallelCountBytes(file.data(), file.size(), counts);
+        for (int ch = 0; ch < 256; ch++) {
+            if (counts[ch] && isalpha(ch)) frequencies[static_cast<char>(tolower(ch))] += counts[ch]; // 统计字符频率
         }
     }
 
     // 执行哈夫曼编码
     void encode() {
         HuffTree huffTree(frequencies);  // 根据字符频率构造哈夫曼树
-        huffTree.generateCodes(huffTree.root, "", huffCode);  // 生成编码
+        huffTree.generateCodes(huffCode);  // 生成编码
     }
 
     // 获取单词的哈夫曼编码
@@ -120,7 +142,111 @@ public:
     }
 };
 
-int main() {
+// 字节流编解码吞吐量测试：统计、整段编解码、分块并行编解码与按块随机解码
+void testCodecThroughput(Benchmark& bench, const uint8_t* input, size_t n, const std::string& params, unsigned threads) {
+    auto same = [&](const std::vector<uint8_t>& v) { return v.size() == n && (n == 0 || memcmp(v.data(), input, n) == 0); };
+    uint64_t freq[256];
+    bench.run("Byte histogram (naive)", params, n, [&] { memset(freq, 0, sizeof(freq)); },
+              [&] { for (size_t i = 0; i < n; i++) freq[input[i]]++; });
+    bench.run("Byte histogram (4 tables)", params, n, [&] { memset(freq, 0, sizeof(freq)); },
+              [&] { countBytes(input, n, freq); });
+    bench.run("Byte histogram (parallel)", params, n, [&] { memset(freq, 0, sizeof(freq)); },
+              [&] { parallelCountBytes(input, n, freq, threads); });
+
+    HuffCodec codec;
+    std::vector<uint8_t> encoded, decoded;
+    BenchResult enc = bench.run("Huffman encode", params, n, [] {},
+                                [&] { encoded = codec.encode(input, n); });
+    BenchResult dec = bench.run("Huffman decode", params, n, [] {},
+                                [&] { decoded = HuffCodec::decode(encoded); });
+    std::cout << "Compressed " << n << " -> " << encoded.size() << " bytes ("
+              << 100.0 * encoded.size() / n << "%), encode " << enc.throughput / 1e6
+              << " MB/s, decode " << dec.throughput / 1e6 << " MB/s, round trip "
+              << (same(decoded) ? "OK" : "FAILED") << std::endl;
+
+    std::string threadParams = params + ", " + std::to_string(huffThreads(threads)) + " threads";
+    enc = bench.run("Chunked encode", threadParams, n, [] {},
+                    [&] { encoded = codec.encodeChunked(input, n, 1 << 20, threads); });
+    dec = bench.run("Chunked decode", threadParams, n, [] {},
+                    [&] { decoded = HuffCodec::decodeChunked(encoded, threads); });
+    std::cout << "Chunked: " << encoded.size() << " bytes, encode " << enc.throughput / 1e6 << " MB/s, decode "
+              << dec.throughput / 1e6 << " MB/s, round trip " << (same(decoded) ? "OK" : "FAILED") << std::endl;
+
+    HuffChunkReader reader(encoded.data(), encoded.size());
+    if (reader.chunkCount() == 0) return;
+    size_t k = reader.chunkCount() / 2;
+    std::vector<uint8_t> chunk(reader.chunkLength(k));
+    bench.run("Random chunk decode", params, chunk.size(), [] {}, [&] { reader.decode(k, chunk.data()); });
+}
+
+// 编码模式对比：仅字母（原实验，丢弃非字母字符）、逐字节、词级静态、词级自适应，
+// 报告压缩率（每输入字节的位数）与编解码吞吐量
+void testCodingModes(Benchmark& bench, const uint8_t* input, size_t n, const std::string& params) {
+    auto report = [&](const std::string& mode, size_t bytes, const BenchResult& enc, const BenchResult& dec, bool ok) {
+        std::cout << mode << ": " << bytes << " bytes, " << 8.0 * bytes / n << " bits/byte, encode "
+                  << enc.throughput / 1e6 << " MB/s, decode " << dec.throughput / 1e6 << " MB/s"
+                  << (ok ? "" : ", round trip FAILED") << std::endl;
+    };
+    auto same = [&](const std::vector<uint8_t>& v) { return v.size() == n && (n == 0 || memcmp(v.data(), input, n) == 0); };
+    std::vector<uint8_t> encoded, decoded;
+
+    std::vector<uint8_t> letters;               // 仅字母模式的输入：小写字母序列
+    for (size_t i = 0; i < n; i++) if (isalpha(input[i])) letters.push_back(static_cast<uint8_t>(tolower(input[i])));
+    HuffCodec codec;
+    BenchResult enc = bench.run("Letter-only encode", params, n, [] {},
+                                [&] { encoded = codec.encode(letters.data(), letters.size()); });
+    BenchResult dec = bench.run("Letter-only decode", params, n, [] {}, [&] { decoded = HuffCodec::decode(encoded); });
+    report("Letter-only (lossy)", encoded.size(), enc, dec, decoded == letters);
+
+    enc = bench.run("Byte encode", params, n, [] {}, [&] { encoded = codec.encode(input, n); });
+    dec = bench.run("Byte decode", params, n, [] {}, [&] { decoded = HuffCodec::decode(encoded); });
+    report("Byte", encoded.size(), enc, dec, same(decoded));
+
+    const char* names[] = { "Word static", "Word adaptive" };
+    for (int m = WordCodec::STATIC; m <= WordCodec::ADAPTIVE; m++) {
+        WordCodec::Mode mode = static_cast<WordCodec::Mode>(m);
+        enc = bench.run(std::string(names[m]) + " encode", params, n, [] {}, [&] { encoded = WordCodec::encode(input, n, mode); });
+        dec = bench.run(std::string(names[m]) + " decode", params, n, [] {}, [&] { decoded = WordCodec::decode(encoded); });
+        report(names[m], encoded.size(), enc, dec, same(decoded));
+    }
+}
+
+// 字节流编解码吞吐量（--bench）：默认把原文重复拼接到 --scale-mb N 兆字节（默认 64，可到 GB 级）；
+// --input 文件 改为直接映射该文件测试；--threads N 指定并行线程数（默认硬件线程数）
+int benchmarkCodecs(int argc, char** argv, const std::string& filename) {
+    size_t targetMB = 64;
+    std::string inputPath;
+    unsigned threads = 0;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--scale-mb") targetMB = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (arg == "--input") inputPath = argv[i + 1];
+        else if (arg == "--threads") threads = static_cast<unsigned>(std::strtoul(argv[i + 1], nullptr, 10));
+    }
+    Benchmark bench(BenchConfig::fromArgs(argc, argv));
+    if (!inputPath.empty()) {
+        MappedFile input(inputPath.c_str());
+        testCodecThroughput(bench, input.data(), input.size(), inputPath, threads);
+        testCodingModes(bench, input.data(), input.size(), inputPath);
+    } else {
+        MappedFile text(filename.c_str());
+        if (text.size() == 0) {
+            std::cout << "Codec benchmark skipped: " << filename << " is empty" << std::endl;
+            return 0;
+        }
+        std::vector<uint8_t> input;
+        size_t target = targetMB << 20;
+        input.reserve(target + text.size());
+        while (input.size() < target) input.insert(input.end(), text.data(), text.data() + text.size());
+        input.resize(target);
+        testCodecThroughput(bench, input.data(), input.size(), std::to_string(targetMB) + " MB", threads);
+        testCodingModes(bench, text.data(), text.size(), filename);
+        testCodingModes(bench, input.data(), input.size(), std::to_string(targetMB) + " MB");
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
     std::string filename = "I have a dream.txt";  // 假设你保存了文章的原文为此文件
     std::ifstream infile(filename);
     if (!infile.is_open()) {
@@ -139,5 +265,9 @@ int main() {
     std::string word = "dream";
     std::cout << "Huffman encoding for word '" << word << "': " << huffman.getCode(word) << std::endl;
 
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--bench") return benchmarkCodecs(argc, argv, filename);
+    }
+
     return 0;
 }
@@ -4,6 +4,13 @@
 #include <stack>
 #include <limits>
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <stdexcept>
+#include <functional>
+#include "../Benchmark.h"
 using namespace std;
 
 // 边的结构体
@@ -16,11 +23,13 @@ bool compareEdges(const Edge& a, const Edge& b) {
     return a.weight < b.weight;
 }
 
-// 查找根节点
-int find(const vector<int>& parent, int i) {
-    if (parent[i] == i)
-        return i;
-    return find(parent, parent[i]);
+// 查找根节点（路径减半，迭代实现，深链也不会爆栈）
+int find(vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
 }
 
 // 合并集合
@@ -37,111 +46,265 @@ void unionSets(vector<int>& parent, vector<int>& rank, int x, int y) {
     }
 }
 
-// 图的结构
+// 在 [0, count) 上按块分给 threads 个线程执行 F(lo, hi)，主线程处理第一块
+template <class F>
+void parallelRanges(size_t count, unsigned threads, F work) {
+    threads = static_cast<unsigned>(min<size_t>(max(1u, threads), max<size_t>(1, count)));
+    size_t step = (count + threads - 1) / threads;
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(work, min(count, t * step), min(count, (t + 1) * step));
+    work(size_t(0), min(count, step));
+    for (auto& th : pool) th.join();
+}
+
+// 图的结构：无向图以压缩稀疏行（CSR）存储，顶点 u 的邻居为 targets[offsets[u] .. offsets[u + 1])，
+// 对应权重在 weights 的同一位置；每条无向边在两端各存一次，邻接表按目标顶点严格升序（无重复边）。
+// addEdge 只把边记入边表，首次查询时再统一建 CSR；也可直接用边表构造
 class Graph {
 private:
     int V; // 顶点数
-    vector<vector<int>> adjMatrix; // 邻接矩阵
+    vector<Edge> pending;           // 尚未建入 CSR 的边
+    vector<int64_t> offsets;        // 长度 V + 1
+    vector<int> targets;
+    vector<int> weights;
+    bool built = false;
+
+    // 由边表并行建 CSR。边表切成 parts 段，每段一个线程：
+    //   1. 各段分别统计本段内每个顶点的度数（每段一个计数数组，不用原子操作）；
+    //   2. 按顶点求和并做前缀和得到 offsets，计数改写为“本段在该顶点邻接表内的起点”；
+    //   3. 各段按自己的游标散布，写入位置互不重叠，邻接表内的顺序即边表顺序；
+    //   4. 各邻接表按目标顶点稳定排序并去重，重复边以边表中最后一条为准（与邻接矩阵的覆盖语义一致）。
+    // 总工作量 O(V * parts + E)；段数不超过 2E / V，计数数组总量与边表同阶。自环不存
+    void build(const vector<Edge>& edges, unsigned threads) {
+        if (!threads) threads = max(1u, thread::hardware_concurrency());
+        for (const Edge& e : edges) {
+            if (e.src < 0 || e.src >= V || e.dest < 0 || e.dest >= V) throw out_of_range("边的顶点编号越界");
+        }
+        size_t E = edges.size();
+        size_t parts = min<size_t>(threads, max<size_t>(1, 2 * E / max(V, 1)));
+        size_t step = (E + parts - 1) / parts;
+        vector<vector<uint32_t>> cursor(parts, vector<uint32_t>(V, 0));
+        parallelRanges(parts, parts, [&](size_t lo, size_t hi) {
+            for (size_t t = lo; t < hi; t++) {
+                for (size_t i = min(E, t * step); i < min(E, (t + 1) * step); i++) {
+                    if (edges[i].src == edges[i].dest) continue;
+                    cursor[t][edges[i].src]++;
+                    cursor[t][edges[i].dest]++;
+                }
+            }
+        });
+        offsets.assign(V + 1, 0);
+        parallelRanges(V, threads, [&](size_t lo, size_t hi) {
+            for (size_t u = lo; u < hi; u++) {
+                uint32_t sum = 0;
+                for (size_t t = 0; t < parts; t++) {
+                    uint32_t c = cursor[t][u];
+                    cursor[t][u] = sum;
+                    sum += c;
+                }
+                offsets[u + 1] = sum;
+            }
+        });
+        for (int u = 0; u < V; u++) offsets[u + 1] += offsets[u];
+        targets.resize(offsets[V]);
+        weights.resize(offsets[V]);
+        parallelRanges(parts, parts, [&](size_t lo, size_t hi) {
+            for (size_t t = lo; t < hi; t++) {
+                for (size_t i = min(E, t * step); i < min(E, (t + 1) * step); i++) {
+                    const Edge& e = edges[i];
+                    if (e.src == e.dest) continue;
+                    int64_t a = offsets[e.src] + cursor[t][e.src]++;
+                    int64_t b = offsets[e.dest] + cursor[t][e.dest]++;
+                    targets[a] = e.dest, weights[a] = e.weight;
+                    targets[b] = e.src, weights[b] = e.weight;
+                }
+            }
+        });
+        vector<vector<uint32_t>>().swap(cursor);
+
+        // 排序去重后各邻接表可能变短，degree[u + 1] 记录保留的项数，有缩短时再整体压紧
+        vector<int64_t> degree(V + 1, 0);
+        parallelRanges(V, threads, [&](size_t lo, size_t hi) {
+            vector<uint64_t> keys;            // (目标顶点, 表内位置)：排序后同一目标的最后一项即边表中最后一条
+            vector<int> w;
+            for (size_t u = lo; u < hi; u++) {
+                int64_t b = offsets[u], e = offsets[u + 1];
+                if (adjacent_find(targets.begin() + b, targets.begin() + e, greater_equal<int>()) == targets.begin() + e) {
+                    degree[u + 1] = e - b;      // 已严格递增：无重复
+                    continue;
+                }
+                keys.clear();
+                for (int64_t k = b; k < e; k++) keys.push_back(static_cast<uint64_t>(targets[k]) << 32 | static_cast<uint64_t>(k - b));
+                sort(keys.begin(), keys.end());
+                w.assign(weights.begin() + b, weights.begin() + e);
+                int64_t m = b;
+                for (size_t k = 0; k < keys.size(); k++) {
+                    if (k + 1 < keys.size() && keys[k + 1] >> 32 == keys[k] >> 32) continue;
+                    targets[m] = static_cast<int>(keys[k] >> 32), weights[m] = w[static_cast<uint32_t>(keys[k])];
+                    m++;
+                }
+                degree[u + 1] = m - b;
+            }
+        });
+        for (int u = 0; u < V; u++) degree[u + 1] += degree[u];
+        if (degree[V] != offsets[V]) {
+            vector<int> t(degree[V]), w(degree[V]);
+            parallelRanges(V, threads, [&](size_t lo, size_t hi) {
+                for (size_t u = lo; u < hi; u++) {
+                    copy_n(targets.begin() + offsets[u], degree[u + 1] - degree[u], t.begin() + degree[u]);
+                    copy_n(weights.begin() + offsets[u], degree[u + 1] - degree[u], w.begin() + degree[u]);
+                }
+            });
+            targets.swap(t);
+            weights.swap(w);
+            offsets.swap(degree);
+        }
+        built = true;
+    }
+
+    void ensureBuilt() {
+        if (built) return;
+        build(pending, 0);
+        vector<Edge>().swap(pending);
+    }
 
 public:
     Graph(int V) {
         this->V = V;
-        adjMatrix.resize(V, vector<int>(V, numeric_limits<int>::max())); // 初始化邻接矩阵为无穷大
-        for (int i = 0; i < V; i++) {
-            adjMatrix[i][i] = 0; // 自己到自己的距离为0
-        }
+    }
+
+    Graph(int V, const vector<Edge>& edges, unsigned threads = 0) {
+        this->V = V;
+        build(edges, threads);
     }
 
     void addEdge(int src, int dest, int weight = 1) {
-        adjMatrix[src][dest] = weight;
-        adjMatrix[dest][src] = weight; // 无向图
+        if (built) {                    // 已建好的 CSR 追加边时整体重建
+            pending = edgeList();
+            built = false;
+        }
+        pending.push_back({ src, dest, weight }); // 无向图
     }
 
-    void printAdjMatrix() {
-        cout << "图的邻接矩阵为：" << endl;
-        for (int i = 0; i < V; i++) {
-            for (int j = 0; j < V; j++) {
-                if (adjMatrix[i][j] == numeric_limits<int>::max()) {
-                    cout << "INF ";
-                }
-                else {
-                    cout << adjMatrix[i][j] << " ";
-                }
+    int vertexCount() const { return V; }
+    int64_t edgeCount() { ensureBuilt(); return offsets[V] / 2; }
+
+    // 每条无向边取一次（src < dest）
+    vector<Edge> edgeList() {
+        ensureBuilt();
+        vector<Edge> edges;
+        edges.reserve(offsets[V] / 2);
+        for (int u = 0; u < V; u++) {
+            for (int64_t k = offsets[u]; k < offsets[u + 1]; k++) {
+                if (u < targets[k]) edges.push_back({ u, targets[k], weights[k] });
+            }
+        }
+        return edges;
+    }
+
+    void printAdjList() {
+        ensureBuilt();
+        cout << "图的邻接表为：" << endl;
+        for (int u = 0; u < V; u++) {
+            cout << u << ":";
+            for (int64_t k = offsets[u]; k < offsets[u + 1]; k++) {
+                cout << " " << targets[k] << "(" << weights[k] << ")";
             }
             cout << endl;
         }
     }
 
-    void BFS(int start) {
+    vector<int> bfsOrder(int start) {
+        ensureBuilt();
         vector<bool> visited(V, false);
-        queue<int> q;
-        q.push(start);
+        vector<int> order;                  // 兼作队列：order[head..] 为待出队顶点
+        order.push_back(start);
         visited[start] = true;
 
-        while (!q.empty()) {
-            int node = q.front();
-            q.pop();
-            cout << node << " ";
-
-            for (int i = 0; i < V; i++) {
-                if (adjMatrix[node][i] != numeric_limits<int>::max() && !visited[i]) {
-                    q.push(i);
+        for (size_t head = 0; head < order.size(); head++) {
+            int node = order[head];
+            for (int64_t k = offsets[node]; k < offsets[node + 1]; k++) {
+                int i = targets[k];
+                if (!visited[i]) {
+                    order.push_back(i);
                     visited[i] = true;
                 }
             }
         }
+        return order;
     }
 
-    void DFSUtil(int node, vector<bool>& visited) {
-        cout << node << " ";
-        visited[node] = true;
+    // 迭代 DFS：栈中保存 (顶点, 下一条待查看的边)，访问顺序与递归版本相同
+    vector<int> dfsOrder(int start) {
+        ensureBuilt();
+        vector<bool> visited(V, false);
+        vector<int> order;
+        vector<pair<int, int64_t>> path;
+        visited[start] = true;
+        order.push_back(start);
+        path.push_back({ start, offsets[start] });
 
-        for (int i = 0; i < V; i++) {
-            if (adjMatrix[node][i] != numeric_limits<int>::max() && !visited[i]) {
-                DFSUtil(i, visited);
+        while (!path.empty()) {
+            int node = path.back().first;
+            int64_t& k = path.back().second;
+            while (k < offsets[node + 1] && visited[targets[k]]) k++;
+            if (k == offsets[node + 1]) {
+                path.pop_back();
+                continue;
             }
+            int i = targets[k++];
+            visited[i] = true;
+            order.push_back(i);
+            path.push_back({ i, offsets[i] });
         }
+        return order;
+    }
+
+    void BFS(int start) {
+        for (int node : bfsOrder(start)) cout << node << " ";
     }
 
     void DFS(int start) {
-        vector<bool> visited(V, false);
-        DFSUtil(start, visited);
+        for (int node : dfsOrder(start)) cout << node << " ";
     }
 
-    void dijkstra(int start) {
-        vector<int> dist(V, numeric_limits<int>::max());
+    // 惰性删除的 Dijkstra：过期的堆项出堆时跳过，O((V + E) log E)。不可达为 int64_t 最大值
+    vector<int64_t> shortestPaths(int start) {
+        ensureBuilt();
+        const int64_t INF = numeric_limits<int64_t>::max();
+        vector<int64_t> dist(V, INF);
         dist[start] = 0;
-        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+        priority_queue<pair<int64_t, int>, vector<pair<int64_t, int>>, greater<>> pq;
         pq.push({ 0, start });
 
         while (!pq.empty()) {
+            int64_t d = pq.top().first;
             int u = pq.top().second;
             pq.pop();
+            if (d > dist[u]) continue;
 
-            for (int v = 0; v < V; v++) {
-                if (adjMatrix[u][v] != numeric_limits<int>::max() && dist[u] + adjMatrix[u][v] < dist[v]) {
-                    dist[v] = dist[u] + adjMatrix[u][v];
+            for (int64_t k = offsets[u]; k < offsets[u + 1]; k++) {
+                int v = targets[k];
+                if (d + weights[k] < dist[v]) {
+                    dist[v] = d + weights[k];
                     pq.push({ dist[v], v });
                 }
             }
         }
+        return dist;
+    }
 
+    void dijkstra(int start) {
+        vector<int64_t> dist = shortestPaths(start);
         cout << "从A点出发的最短路径结果为：" << endl;
         for (int i = 0; i < V; i++) {
-            cout << "A到" << i << "的最短距离为：" << dist[i] << endl;
+            if (dist[i] == numeric_limits<int64_t>::max()) cout << "A到" << i << "的最短距离为：INF" << endl;
+            else cout << "A到" << i << "的最短距离为：" << dist[i] << endl;
         }
     }
 
-    void kruskalMST() {
-        vector<Edge> edges;
-        for (int i = 0; i < V; i++) {
-            for (int j = i + 1; j < V; j++) {
-                if (adjMatrix[i][j] != numeric_limits<int>::max()) {
-                    edges.push_back({ i, j, adjMatrix[i][j] });
-                }
-            }
-        }
-
+    vector<Edge> minimumSpanningTree() {
+        vector<Edge> edges = edgeList();
         sort(edges.begin(), edges.end(), compareEdges);
 
         vector<int> parent(V);
@@ -157,9 +320,14 @@ public:
             if (x != y) {
                 mst.push_back(edge);
                 unionSets(parent, rank, x, y);
+                if (static_cast<int>(mst.size()) == V - 1) break;   // 已连通全部顶点
             }
         }
+        return mst;
+    }
 
+    void kruskalMST() {
+        vector<Edge> mst = minimumSpanningTree();
         cout << "最小支撑树的边为：" << endl;
         for (const Edge& edge : mst) {
             cout << edge.src << " - " << edge.dest << " : " << edge.weight << endl;
@@ -167,7 +335,43 @@ public:
     }
 };
 
-int main() {
+// 基准测试：随机稀疏图（每个顶点平均 3 条边，另加一条链保证连通），测建图与四种算法
+void benchmarkGraph(Benchmark& bench, int V) {
+    srand(bench.config().seed);
+    vector<Edge> edges;
+    edges.reserve(static_cast<size_t>(V) * 4);
+    for (int u = 1; u < V; u++) edges.push_back({ u - 1, u, 1 + rand() % 100 });
+    for (size_t k = 0; k < static_cast<size_t>(V) * 3; k++) edges.push_back({ rand() % V, rand() % V, 1 + rand() % 100 });
+    size_t E = edges.size();
+    unsigned hw = max(1u, thread::hardware_concurrency());
+
+    bench.run("CSR build", to_string(hw) + " threads", E, [] {}, [&] { Graph g(V, edges, hw); });
+    Graph g(V, edges, hw);
+    size_t visited = 0;
+    int64_t total = 0;
+    bench.run("BFS", "CSR", E, [] {}, [&] { visited = g.bfsOrder(0).size(); });
+    bench.run("DFS (iterative)", "CSR", E, [] {}, [&] { visited = g.dfsOrder(0).size(); });
+    bench.run("Dijkstra (lazy)", "CSR", E, [] {}, [&] { total = g.shortestPaths(0)[V - 1]; });
+    bench.run("Kruskal", "CSR", E, [] {}, [&] {
+        total = 0;
+        for (const Edge& e : g.minimumSpanningTree()) total += e.weight;
+    });
+    cout << "Visited " << visited << " vertices, MST weight " << total << endl;
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--bench") {
+            int V = 1 << 20;
+            for (int j = 1; j + 1 < argc; j++) {
+                if (string(argv[j]) == "--vertices") V = max(2, atoi(argv[j + 1]));
+            }
+            Benchmark bench(BenchConfig::fromArgs(argc, argv));
+            benchmarkGraph(bench, V);
+            return 0;
+        }
+    }
+
     int V = 6; // 假设图1有6个顶点
     Graph g(V);
 
@@ -180,8 +384,8 @@ int main() {
     g.addEdge(3, 5, 4); // D-F
     g.addEdge(4, 5, 1); // E-F
 
-    // 输出邻接矩阵
-    g.printAdjMatrix();
+    // 输出邻接表
+    g.printAdjList();
 
     // BFS和DFS
     cout << "从A点出发的BFS遍历结果为：" << endl;
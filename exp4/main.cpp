@@ -6,11 +6,52 @@
 #include <cmath>
 #include <chrono>
 #include <functional> // 包含 std::function 的头文件
+#include <thread>
+#include <atomic>
+#include <tuple>
+#include "../Benchmark.h"
+#include <cstdint>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NMS_X86 1
+#endif
 
 // 边界框结构
 struct BoundingBox {
     int x1, y1, x2, y2;
     float confidence;
+    int classId = 0;    // 类别编号，类别感知 NMS 只在同类框之间抑制
+};
+
+// 结构数组（SoA）形式的边界框集合：排序与 NMS 只访问各自需要的列
+struct BoundingBoxSet {
+    std::vector<float> x1, y1, x2, y2;
+    std::vector<float> confidence;
+    std::vector<float> area;            // 预先计算的面积
+
+    size_t size() const { return confidence.size(); }
+
+    void reserve(size_t n) {
+        x1.reserve(n); y1.reserve(n); x2.reserve(n); y2.reserve(n);
+        confidence.reserve(n); area.reserve(n);
+    }
+
+    void push_back(const BoundingBox& b) {
+        x1.push_back(static_cast<float>(b.x1));
+        y1.push_back(static_cast<float>(b.y1));
+        x2.push_back(static_cast<float>(b.x2));
+        y2.push_back(static_cast<float>(b.y2));
+        confidence.push_back(b.confidence);
+        area.push_back(static_cast<float>(b.x2 - b.x1) * static_cast<float>(b.y2 - b.y1));
+    }
+
+    static BoundingBoxSet fromBoxes(const std::vector<BoundingBox>& boxes) {
+        BoundingBoxSet set;
+        set.reserve(boxes.size());
+        for (const auto& b : boxes) set.push_back(b);
+        return set;
+    }
 };
 
 // 一、排序算法实现
@@ -59,6 +100,181 @@ void mergeSort(std::vector<float>& arr, int l, int r) {
     }
 }
 
+// 并行归并排序：上层拆分交给新线程，合并按协同秩切分给多个线程，全程共用一块乒乓缓冲区
+const int PARALLEL_CUTOFF = 1 << 14;
+
+// 求 j + k = i，使 a[0, m) 与 b[0, n) 稳定归并的前 i 个输出恰为 a[0, j) 与 b[0, k)
+int corank(int i, const float* a, int m, const float* b, int n) {
+    int j = std::min(i, m), k = i - j;
+    int jLow = std::max(0, i - n), kLow = std::max(0, i - m);
+    while (true) {
+        if (j > 0 && k < n && a[j - 1] > b[k]) {
+            int d = (j - jLow + 1) / 2;
+            kLow = k; j -= d; k += d;
+        }
+        else if (k > 0 && j < m && b[k - 1] >= a[j]) {
+            int d = (k - kLow + 1) / 2;
+            jLow = j; j += d; k -= d;
+        }
+        else {
+            return j;
+        }
+    }
+}
+
+void mergeRange(const float* a, int m, const float* b, int n, float* out) {
+    int i = 0, j = 0, k = 0;
+    while (i < m && j < n) out[k++] = (b[j] < a[i]) ? b[j++] : a[i++];
+    while (i < m) out[k++] = a[i++];
+    while (j < n) out[k++] = b[j++];
+}
+
+void parallelMerge(const float* a, int m, const float* b, int n, float* out, int threads) {
+    if (threads < 2 || m + n < PARALLEL_CUTOFF) {
+        mergeRange(a, m, b, n, out);
+        return;
+    }
+    std::vector<std::thread> workers;
+    int total = m + n, j0 = 0;
+    for (int t = 0; t < threads; t++) {
+        int i0 = static_cast<int>(static_cast<long long>(total) * t / threads);
+        int i1 = static_cast<int>(static_cast<long long>(total) * (t + 1) / threads);
+        int j1 = corank(i1, a, m, b, n);
+        int k0 = i0 - j0, k1 = i1 - j1;
+        if (t + 1 == threads) mergeRange(a + j0, j1 - j0, b + k0, k1 - k0, out + i0);
+        else workers.emplace_back(mergeRange, a + j0, j1 - j0, b + k0, k1 - k0, out + i0);
+        j0 = j1;
+    }
+    for (auto& w : workers) w.join();
+}
+
+// 对 a[0, n) 做自底向上归并排序，toB 为真时结果写入 b，否则写回 a
+void leafSort(float* a, float* b, int n, bool toB) {
+    const int RUN = 32;
+    for (int lo = 0; lo < n; lo += RUN) {
+        int hi = std::min(lo + RUN, n);
+        for (int i = lo + 1; i < hi; i++) {
+            float key = a[i];
+            int j = i - 1;
+            while (j >= lo && a[j] > key) { a[j + 1] = a[j]; j--; }
+            a[j + 1] = key;
+        }
+    }
+    float* src = a;
+    float* dst = b;
+    for (int w = RUN; w < n; w *= 2, std::swap(src, dst)) {
+        for (int lo = 0; lo < n; lo += 2 * w) {
+            int m = std::min(w, n - lo), r = std::min(w, n - lo - m);
+            mergeRange(src + lo, m, src + lo + m, r, dst + lo);
+        }
+    }
+    if ((src == b) != toB) std::copy(src, src + n, toB ? b : a);
+}
+
+void parallelSort(float* a, float* b, int n, bool toB, int threads) {
+    if (threads < 2 || n < PARALLEL_CUTOFF) {
+        leafSort(a, b, n, toB);
+        return;
+    }
+    int mid = n / 2, lt = threads / 2;
+    std::thread left(parallelSort, a, b, mid, !toB, lt);
+    parallelSort(a + mid, b + mid, n - mid, !toB, threads - lt);
+    left.join();
+    const float* src = toB ? a : b;
+    parallelMerge(src, mid, src + mid, n - mid, toB ? b : a, threads);
+}
+
+// threads 为 0 时使用全部硬件线程
+void parallelMergeSort(std::vector<float>& arr, int threads = 0) {
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<float> buffer(arr.size());
+    parallelSort(arr.data(), buffer.data(), static_cast<int>(arr.size()), false, threads);
+}
+
+// 基数排序（LSD，每趟 8 位）
+// 浮点数按位映射为保序的无符号整数：负数全部取反，非负数翻转符号位
+inline uint32_t floatKey(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+void radixSort(std::vector<float>& arr) {
+    size_t n = arr.size();
+    if (n < 2) return;
+    size_t count[4][256] = {};
+    for (float f : arr) {
+        uint32_t k = floatKey(f);
+        for (int d = 0; d < 4; d++) count[d][(k >> (8 * d)) & 0xFF]++;
+    }
+    std::vector<float> buffer(n);
+    float* src = arr.data();
+    float* dst = buffer.data();
+    uint32_t first = floatKey(src[0]);
+    for (int d = 0; d < 4; d++) {
+        if (count[d][(first >> (8 * d)) & 0xFF] == n) continue; // 本字节全部相同，跳过
+        size_t offset[256], sum = 0;
+        for (int b = 0; b < 256; b++) { offset[b] = sum; sum += count[d][b]; }
+        for (size_t i = 0; i < n; i++) dst[offset[(floatKey(src[i]) >> (8 * d)) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+    }
+    if (src != arr.data()) std::copy(src, src + n, arr.data());
+}
+
+// 键-索引排序：只对 (置信度键, 下标) 排序得到置换，再一次性重排记录
+// 键放在高 32 位、下标放在低 32 位，只需对高 4 字节做 LSD 基数排序；同键按下标有序（稳定）
+std::vector<int> sortIndicesByKey(const std::vector<float>& keys, bool descending) {
+    size_t n = keys.size();
+    std::vector<uint64_t> pairs(n), buffer(n);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t k = floatKey(keys[i]);
+        if (descending) k = ~k;
+        pairs[i] = (static_cast<uint64_t>(k) << 32) | static_cast<uint32_t>(i);
+    }
+    uint64_t* src = pairs.data();
+    uint64_t* dst = buffer.data();
+    for (int d = 4; d < 8; d++) {
+        size_t count[256] = {};
+        for (size_t i = 0; i < n; i++) count[(src[i] >> (8 * d)) & 0xFF]++;
+        if (n > 0 && count[(src[0] >> (8 * d)) & 0xFF] == n) continue;
+        size_t offset[256], sum = 0;
+        for (int b = 0; b < 256; b++) { offset[b] = sum; sum += count[b]; }
+        for (size_t i = 0; i < n; i++) dst[offset[(src[i] >> (8 * d)) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+    }
+    std::vector<int> order(n);
+    for (size_t i = 0; i < n; i++) order[i] = static_cast<int>(src[i] & 0xFFFFFFFFu);
+    return order;
+}
+
+// 按置换重排：result[i] = v[order[i]]
+template <typename T>
+void applyPermutation(std::vector<T>& v, const std::vector<int>& order) {
+    std::vector<T> result(order.size());
+    for (size_t i = 0; i < order.size(); i++) result[i] = v[order[i]];
+    v.swap(result);
+}
+
+void applyPermutation(BoundingBoxSet& set, const std::vector<int>& order) {
+    applyPermutation(set.x1, order);
+    applyPermutation(set.y1, order);
+    applyPermutation(set.x2, order);
+    applyPermutation(set.y2, order);
+    applyPermutation(set.confidence, order);
+    applyPermutation(set.area, order);
+}
+
+// 按置信度排序边界框：先排 (键, 下标)，再搬动记录一次
+void sortByConfidence(std::vector<BoundingBox>& bboxes, bool descending = true) {
+    std::vector<float> keys(bboxes.size());
+    for (size_t i = 0; i < bboxes.size(); i++) keys[i] = bboxes[i].confidence;
+    applyPermutation(bboxes, sortIndicesByKey(keys, descending));
+}
+
+void sortByConfidence(BoundingBoxSet& set, bool descending = true) {
+    applyPermutation(set, sortIndicesByKey(set.confidence, descending));
+}
+
 // 冒泡排序
 void bubbleSort(std::vector<float>& arr) {
     int n = arr.size();
@@ -98,11 +314,11 @@ float computeIOU(const BoundingBox& boxA, const BoundingBox& boxB) {
     return interArea / (boxAArea + boxBArea - interArea);
 }
 
+// 朴素 NMS：从尾部逐个挑选，每轮复制幸存者，O(n^2)
 std::vector<BoundingBox> nms(std::vector<BoundingBox>& bboxes, float threshold) {
     std::vector<BoundingBox> pick;
-    std::sort(bboxes.begin(), bboxes.end(), [](const BoundingBox& a, const BoundingBox& b) {
-        return a.confidence > b.confidence;
-        });
+    sortByConfidence(bboxes);
+    std::reverse(bboxes.begin(), bboxes.end()); // 翻转后尾部为置信度最高者
     while (!bboxes.empty()) {
         BoundingBox last = bboxes.back();
         pick.push_back(last);
@@ -118,6 +334,295 @@ std::vector<BoundingBox> nms(std::vector<BoundingBox>& bboxes, float threshold)
     return pick;
 }
 
+// SoA 上的 IoU，面积已预先计算
+inline float computeIOU(const BoundingBoxSet& set, int a, int b) {
+    float interW = std::min(set.x2[a], set.x2[b]) - std::max(set.x1[a], set.x1[b]);
+    float interH = std::min(set.y2[a], set.y2[b]) - std::max(set.y1[a], set.y1[b]);
+    float interArea = std::max(0.0f, interW) * std::max(0.0f, interH);
+    return interArea / (set.area[a] + set.area[b] - interArea);
+}
+
+// 扫描线 NMS：按置信度降序处理，用位图标记抑制，不复制幸存者；
+// 另按 x1 排序，每个入选框只需与 x 方向可能重叠的框（x1 落在 (x1 - 最大宽度, x2) 内）比较。
+// 已处理或已抑制的框从 x 序列中摘除（带路径压缩的“下一个存活位置”指针），扫描时直接跳过。
+// 返回保留框在 set 中的下标，按置信度降序排列。
+int nextAlive(std::vector<int>& next, int k) {
+    int root = k;
+    while (next[root] != root) root = next[root];
+    while (next[k] != root) { int t = next[k]; next[k] = root; k = t; }
+    return root;
+}
+
+std::vector<int> nmsSweep(const BoundingBoxSet& set, float threshold) {
+    int n = static_cast<int>(set.size());
+    std::vector<int> order = sortIndicesByKey(set.confidence, true);
+    std::vector<int> byX = sortIndicesByKey(set.x1, false);
+    std::vector<int> posX(n);
+    std::vector<float> sortedX1(n);
+    float maxWidth = 0.0f;
+    for (int k = 0; k < n; k++) {
+        posX[byX[k]] = k;
+        sortedX1[k] = set.x1[byX[k]];
+        maxWidth = std::max(maxWidth, set.x2[k] - set.x1[k]);
+    }
+    std::vector<int> next(n + 1);
+    for (int k = 0; k <= n; k++) next[k] = k;
+
+    std::vector<uint64_t> suppressed((n + 63) / 64, 0);
+    std::vector<int> keep;
+    for (int r = 0; r < n; r++) {
+        int i = order[r];
+        if (suppressed[i >> 6] >> (i & 63) & 1) continue;
+        keep.push_back(i);
+        next[posX[i]] = posX[i] + 1;
+        int lo = static_cast<int>(std::upper_bound(sortedX1.begin(), sortedX1.end(), set.x1[i] - maxWidth) - sortedX1.begin());
+        int hi = static_cast<int>(std::lower_bound(sortedX1.begin(), sortedX1.end(), set.x2[i]) - sortedX1.begin());
+        for (int k = nextAlive(next, lo); k < hi; k = nextAlive(next, k + 1)) {
+            int j = byX[k];
+            if (set.y1[j] >= set.y2[i] || set.y2[j] <= set.y1[i]) continue;
+            if (computeIOU(set, i, j) > threshold) {
+                suppressed[j >> 6] |= uint64_t(1) << (j & 63);
+                next[k] = k + 1;
+            }
+        }
+    }
+    return keep;
+}
+
+std::vector<BoundingBox> nmsSweep(const std::vector<BoundingBox>& bboxes, float threshold) {
+    BoundingBoxSet set = BoundingBoxSet::fromBoxes(bboxes);
+    std::vector<BoundingBox> pick;
+    for (int i : nmsSweep(set, threshold)) pick.push_back(bboxes[i]);
+    return pick;
+}
+
+// 批量 IoU 内核：一个框对 SoA 中连续 8 个框 [j, j + 8) 计算 IoU，
+// 返回 IoU > threshold 的位掩码（第 b 位对应 j + b）。运算顺序与标量 computeIOU 一致，结果逐位相同。
+typedef unsigned (*IouBlockKernel)(const BoundingBoxSet& set, int i, int j, float threshold);
+
+unsigned iouBlockScalar(const BoundingBoxSet& set, int i, int j, float threshold) {
+    unsigned mask = 0;
+    for (int b = 0; b < 8; b++) {
+        if (computeIOU(set, i, j + b) > threshold) mask |= 1u << b;
+    }
+    return mask;
+}
+
+#ifdef NMS_X86
+unsigned iouBlockSse(const BoundingBoxSet& set, int i, int j, float threshold) {
+    __m128 ax1 = _mm_set1_ps(set.x1[i]), ay1 = _mm_set1_ps(set.y1[i]);
+    __m128 ax2 = _mm_set1_ps(set.x2[i]), ay2 = _mm_set1_ps(set.y2[i]);
+    __m128 aArea = _mm_set1_ps(set.area[i]), thr = _mm_set1_ps(threshold), zero = _mm_setzero_ps();
+    unsigned mask = 0;
+    for (int h = 0; h < 8; h += 4) {
+        int k = j + h;
+        __m128 w = _mm_sub_ps(_mm_min_ps(ax2, _mm_loadu_ps(&set.x2[k])), _mm_max_ps(ax1, _mm_loadu_ps(&set.x1[k])));
+        __m128 hgt = _mm_sub_ps(_mm_min_ps(ay2, _mm_loadu_ps(&set.y2[k])), _mm_max_ps(ay1, _mm_loadu_ps(&set.y1[k])));
+        __m128 inter = _mm_mul_ps(_mm_max_ps(w, zero), _mm_max_ps(hgt, zero));
+        __m128 uni = _mm_sub_ps(_mm_add_ps(aArea, _mm_loadu_ps(&set.area[k])), inter);
+        __m128 iou = _mm_div_ps(inter, uni);
+        mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_cmpgt_ps(iou, thr))) << h;
+    }
+    return mask;
+}
+
+__attribute__((target("avx2")))
+unsigned iouBlockAvx2(const BoundingBoxSet& set, int i, int j, float threshold) {
+    __m256 ax1 = _mm256_set1_ps(set.x1[i]), ay1 = _mm256_set1_ps(set.y1[i]);
+    __m256 ax2 = _mm256_set1_ps(set.x2[i]), ay2 = _mm256_set1_ps(set.y2[i]);
+    __m256 aArea = _mm256_set1_ps(set.area[i]), zero = _mm256_setzero_ps();
+    __m256 w = _mm256_sub_ps(_mm256_min_ps(ax2, _mm256_loadu_ps(&set.x2[j])), _mm256_max_ps(ax1, _mm256_loadu_ps(&set.x1[j])));
+    __m256 hgt = _mm256_sub_ps(_mm256_min_ps(ay2, _mm256_loadu_ps(&set.y2[j])), _mm256_max_ps(ay1, _mm256_loadu_ps(&set.y1[j])));
+    __m256 inter = _mm256_mul_ps(_mm256_max_ps(w, zero), _mm256_max_ps(hgt, zero));
+    __m256 uni = _mm256_sub_ps(_mm256_add_ps(aArea, _mm256_loadu_ps(&set.area[j])), inter);
+    __m256 iou = _mm256_div_ps(inter, uni);
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(iou, _mm256_set1_ps(threshold), _CMP_GT_OQ)));
+}
+#endif
+
+// 运行时按 CPU 能力选择内核
+IouBlockKernel selectIouKernel() {
+#ifdef NMS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return iouBlockAvx2;
+    return iouBlockSse;
+#else
+    return iouBlockScalar;
+#endif
+}
+
+// 批量 NMS：先把 SoA 按置信度降序重排，之后每个入选框以 8 个为一块向后批量计算 IoU，
+// 整块已被抑制时跳过。kernel 为空时自动选择；topK > 0 时选满 topK 个即提前结束。
+// 返回保留框在 set 中的下标。
+std::vector<int> nmsBatched(const BoundingBoxSet& set, float threshold, IouBlockKernel kernel = nullptr, int topK = 0) {
+    static const IouBlockKernel best = selectIouKernel();
+    if (!kernel) kernel = best;
+    int n = static_cast<int>(set.size());
+    std::vector<int> order = sortIndicesByKey(set.confidence, true);
+    BoundingBoxSet sorted = set;
+    applyPermutation(sorted, order);
+
+    std::vector<uint8_t> suppressed(n + 8, 0);
+    std::vector<int> keep;
+    for (int i = 0; i < n; i++) {
+        if (suppressed[i]) continue;
+        keep.push_back(order[i]);
+        if (topK > 0 && static_cast<int>(keep.size()) == topK) break;
+        int j = i + 1;
+        for (; j + 8 <= n; j += 8) {
+            uint64_t block;
+            std::memcpy(&block, &suppressed[j], sizeof(block));
+            if (block == 0x0101010101010101ull) continue;
+            unsigned mask = kernel(sorted, i, j, threshold);
+            for (; mask; mask &= mask - 1) suppressed[j + __builtin_ctz(mask)] = 1;
+        }
+        for (; j < n; j++) {
+            if (computeIOU(sorted, i, j) > threshold) suppressed[j] = 1;
+        }
+    }
+    return keep;
+}
+
+std::vector<BoundingBox> nmsBatched(const std::vector<BoundingBox>& bboxes, float threshold) {
+    BoundingBoxSet set = BoundingBoxSet::fromBoxes(bboxes);
+    std::vector<BoundingBox> pick;
+    for (int i : nmsBatched(set, threshold)) pick.push_back(bboxes[i]);
+    return pick;
+}
+
+// 多类别 / Soft-NMS 接口
+enum class NmsMode {
+    Hard,           // 硬抑制：IoU 超过阈值即删除
+    SoftLinear,     // 线性衰减：IoU 超过阈值时分数乘以 (1 - IoU)
+    SoftGaussian    // 高斯衰减：分数乘以 exp(-IoU^2 / sigma)
+};
+
+struct NmsOptions {
+    NmsMode mode = NmsMode::Hard;
+    float iouThreshold = 0.5f;
+    float sigma = 0.5f;             // 高斯衰减参数
+    float scoreThreshold = 0.001f;  // Soft-NMS 中分数低于此值的框被丢弃
+    int topK = 0;                   // 每类及最终结果最多保留的框数，0 表示不限
+    bool classAware = true;         // 为假时忽略 classId，全部视为同一类
+    int threads = 0;                // 并行线程数，0 表示使用全部硬件线程
+};
+
+// Soft-NMS：每轮选出剩余分数最高者，按 IoU 衰减其余框的分数。返回选中框在 set 中的下标（按选中顺序），
+// scores 非空时写入对应的衰减后置信度
+std::vector<int> softNms(const BoundingBoxSet& set, const NmsOptions& opt, std::vector<float>* scores = nullptr) {
+    int n = static_cast<int>(set.size());
+    std::vector<float> score = set.confidence;
+    std::vector<int> alive(n);
+    for (int i = 0; i < n; i++) alive[i] = i;
+
+    std::vector<int> pick;
+    if (scores) scores->clear();
+    while (!alive.empty()) {
+        size_t best = 0;
+        for (size_t k = 1; k < alive.size(); k++) {
+            if (score[alive[k]] > score[alive[best]]) best = k;
+        }
+        int i = alive[best];
+        alive[best] = alive.back();
+        alive.pop_back();
+
+        pick.push_back(i);
+        if (scores) scores->push_back(score[i]);
+        if (opt.topK > 0 && static_cast<int>(pick.size()) == opt.topK) break;
+
+        size_t w = 0;
+        for (size_t k = 0; k < alive.size(); k++) {
+            int j = alive[k];
+            float iou = computeIOU(set, i, j);
+            if (opt.mode == NmsMode::SoftLinear) {
+                if (iou > opt.iouThreshold) score[j] *= 1.0f - iou;
+            }
+            else {
+                score[j] *= std::exp(-iou * iou / opt.sigma);
+            }
+            if (score[j] >= opt.scoreThreshold) alive[w++] = j;
+        }
+        alive.resize(w);
+    }
+    return pick;
+}
+
+// 对单类框执行所选模式的 NMS
+std::vector<BoundingBox> nmsSingleClass(const std::vector<BoundingBox>& bboxes, const NmsOptions& opt) {
+    BoundingBoxSet set = BoundingBoxSet::fromBoxes(bboxes);
+    std::vector<BoundingBox> pick;
+    if (opt.mode == NmsMode::Hard) {
+        for (int i : nmsBatched(set, opt.iouThreshold, nullptr, opt.topK)) pick.push_back(bboxes[i]);
+    }
+    else {
+        std::vector<float> scores;
+        std::vector<int> idx = softNms(set, opt, &scores);
+        for (size_t k = 0; k < idx.size(); k++) {     // 取回原框，保留各自的 classId
+            pick.push_back(bboxes[idx[k]]);
+            pick.back().confidence = scores[k];
+        }
+    }
+    return pick;
+}
+
+// 用 threads 个线程并行执行 task(0 .. count - 1)，任务通过原子计数器动态领取
+void parallelFor(int count, int threads, const std::function<void(int)>& task) {
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, count);
+    std::atomic<int> nextTask(0);
+    auto worker = [&]() {
+        for (int t; (t = nextTask.fetch_add(1)) < count; ) task(t);
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers) w.join();
+}
+
+// 按置信度降序排列并截取前 topK 个
+void finalizeDetections(std::vector<BoundingBox>& pick, int topK) {
+    sortByConfidence(pick);
+    if (topK > 0 && static_cast<int>(pick.size()) > topK) pick.resize(topK);
+}
+
+// 类别感知 NMS：一批框按 classId 分组，各类别并行处理后合并，按置信度降序返回
+std::vector<BoundingBox> nmsMultiClass(const std::vector<BoundingBox>& bboxes, const NmsOptions& opt) {
+    std::vector<std::vector<BoundingBox>> groups;
+    if (opt.classAware) {               // 按 classId 稳定排序后切分，类别编号可为任意 int
+        std::vector<BoundingBox> sorted = bboxes;
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [](const BoundingBox& a, const BoundingBox& b) { return a.classId < b.classId; });
+        for (size_t i = 0; i < sorted.size(); i++) {
+            if (i == 0 || sorted[i].classId != sorted[i - 1].classId) groups.emplace_back();
+            groups.back().push_back(sorted[i]);
+        }
+    }
+    else {
+        groups.push_back(bboxes);
+    }
+
+    std::vector<std::vector<BoundingBox>> results(groups.size());
+    parallelFor(static_cast<int>(groups.size()), opt.threads, [&](int c) {
+        results[c] = nmsSingleClass(groups[c], opt);
+    });
+
+    std::vector<BoundingBox> pick;
+    for (const auto& r : results) pick.insert(pick.end(), r.begin(), r.end());
+    finalizeDetections(pick, opt.topK);
+    return pick;
+}
+
+// 多张图像的批量 NMS：图像之间并行，每张图像内部串行
+std::vector<std::vector<BoundingBox>> nmsImages(const std::vector<std::vector<BoundingBox>>& images, const NmsOptions& opt) {
+    NmsOptions single = opt;
+    single.threads = 1;
+    std::vector<std::vector<BoundingBox>> results(images.size());
+    parallelFor(static_cast<int>(images.size()), opt.threads, [&](int k) {
+        results[k] = nmsMultiClass(images[k], single);
+    });
+    return results;
+}
+
 // 三、数据生成
 
 std::vector<BoundingBox> generateRandomBboxes(int numBboxes) {
@@ -151,46 +656,113 @@ std::vector<BoundingBox> generateClusteredBboxes(int numBboxes) {
 }
 
 // 四、性能测试
+// 每种 (分布, 规模) 只用固定种子生成一次数据，所有算法在相同输入上测量；计时与统计由 Benchmark 完成
 
-void testSortingAlgorithms() {
-    std::vector<std::string> sortingAlgorithms = { "Quick Sort", "Merge Sort", "Bubble Sort", "Insertion Sort" };
-    std::vector<int> dataScales = { 100, 1000, 5000, 10000 };
+void testSortingAlgorithms(Benchmark& bench) {
+    std::vector<std::string> sortingAlgorithms = { "Quick Sort", "Merge Sort", "Parallel Merge Sort", "Radix Sort", "Bubble Sort", "Insertion Sort" };
+    std::vector<std::function<void(std::vector<float>&)>> sortFuncs = {
+        [](std::vector<float>& a) { quickSort(a, 0, static_cast<int>(a.size()) - 1); },
+        [](std::vector<float>& a) { mergeSort(a, 0, static_cast<int>(a.size()) - 1); },
+        [](std::vector<float>& a) { parallelMergeSort(a); },
+        [](std::vector<float>& a) { radixSort(a); },
+        [](std::vector<float>& a) { bubbleSort(a); },
+        [](std::vector<float>& a) { insertionSort(a); }
+    };
+    std::vector<bool> quadratic = { false, false, false, false, true, true };
+    const int quadraticLimit = 10000;   // O(n^2) 算法只测到此规模
+    std::vector<int> dataScales = { 100, 1000, 5000, 10000, 100000, 1000000 };
     std::vector<std::string> distributions = { "Random", "Clustered" };
     std::vector<std::function<std::vector<BoundingBox>(int)>> genFuncs = { generateRandomBboxes, generateClusteredBboxes };
 
-    for (const auto& algo : sortingAlgorithms) {
-        for (size_t distIdx = 0; distIdx < distributions.size(); distIdx++) {
-            for (int scale : dataScales) {
-                auto bboxes = genFuncs[distIdx](scale);
-                std::vector<float> confidences;
-                for (const auto& bbox : bboxes) {
-                    confidences.push_back(bbox.confidence);
-                }
-
-                auto start = std::chrono::high_resolution_clock::now();
-                if (algo == "Quick Sort") {
-                    quickSort(confidences, 0, confidences.size() - 1);
-                }
-                else if (algo == "Merge Sort") {
-                    mergeSort(confidences, 0, confidences.size() - 1);
-                }
-                else if (algo == "Bubble Sort") {
-                    bubbleSort(confidences);
-                }
-                else if (algo == "Insertion Sort") {
-                    insertionSort(confidences);
-                }
-                auto end = std::chrono::high_resolution_clock::now();
-                std::chrono::duration<double> duration = end - start;
-
-                std::cout << algo << " on " << distributions[distIdx] << " data with " << scale << " bboxes: " << duration.count() << " seconds" << std::endl;
+    for (size_t distIdx = 0; distIdx < distributions.size(); distIdx++) {
+        for (int scale : dataScales) {
+            srand(bench.config().seed + static_cast<unsigned>(distIdx * 1000003 + scale));
+            auto bboxes = genFuncs[distIdx](scale);
+            std::vector<float> confidences;
+            for (const auto& bbox : bboxes) {
+                confidences.push_back(bbox.confidence);
             }
+
+            std::vector<float> work;
+            for (size_t algo = 0; algo < sortingAlgorithms.size(); algo++) {
+                if (quadratic[algo] && scale > quadraticLimit) continue;
+                bench.run(sortingAlgorithms[algo], distributions[distIdx] + " confidences", scale,
+                          [&]() { work = confidences; },
+                          [&]() { sortFuncs[algo](work); });
+            }
+        }
+    }
+}
+
+// 两组检测结果是否保留了相同的框（坐标、置信度、classId 逐项相同，与输出顺序无关）
+bool sameDetections(std::vector<BoundingBox> a, std::vector<BoundingBox> b) {
+    if (a.size() != b.size()) return false;
+    auto key = [](const BoundingBox& x) { return std::make_tuple(-x.confidence, x.x1, x.y1, x.x2, x.y2, x.classId); };
+    auto less = [&](const BoundingBox& x, const BoundingBox& y) { return key(x) < key(y); };
+    std::sort(a.begin(), a.end(), less);
+    std::sort(b.begin(), b.end(), less);
+    for (size_t i = 0; i < a.size(); i++) {
+        if (key(a[i]) != key(b[i])) return false;
+    }
+    return true;
+}
+
+void testNmsAlgorithms(Benchmark& bench) {
+    std::vector<int> dataScales = { 1000, 5000, 10000 };
+    std::vector<std::string> distributions = { "Random", "Clustered" };
+    std::vector<std::function<std::vector<BoundingBox>(int)>> genFuncs = { generateRandomBboxes, generateClusteredBboxes };
+    const float threshold = 0.5f;
+
+    for (size_t distIdx = 0; distIdx < distributions.size(); distIdx++) {
+        for (int scale : dataScales) {
+            srand(bench.config().seed + static_cast<unsigned>(distIdx * 1000003 + scale));
+            auto bboxes = genFuncs[distIdx](scale);
+            std::string params = distributions[distIdx] + " bboxes";
+
+            std::vector<BoundingBox> work, naive, sweep, batched;
+            bench.run("NMS naive", params, scale, [&]() { work = bboxes; }, [&]() { naive = nms(work, threshold); });
+            bench.run("NMS sweep", params, scale, []() {}, [&]() { sweep = nmsSweep(bboxes, threshold); });
+            bench.run("NMS simd", params, scale, []() {}, [&]() { batched = nmsBatched(bboxes, threshold); });
+            if (!sameDetections(naive, sweep) || !sameDetections(naive, batched)) {
+                std::cerr << "NMS results differ on " << params << " with " << scale << " bboxes" << std::endl;
+            }
+        }
+    }
+}
+
+void testMultiClassNms(Benchmark& bench) {
+    std::vector<int> dataScales = { 1000, 5000, 10000 };
+    const int numClasses = 10;
+    NmsOptions hard, linear, gaussian;
+    linear.mode = NmsMode::SoftLinear;
+    gaussian.mode = NmsMode::SoftGaussian;
+    std::vector<std::string> names = { "Multi-class NMS hard", "Multi-class Soft-NMS linear", "Multi-class Soft-NMS gaussian" };
+    std::vector<NmsOptions> modes = { hard, linear, gaussian };
+
+    for (int scale : dataScales) {
+        srand(bench.config().seed + static_cast<unsigned>(scale));
+        auto bboxes = generateClusteredBboxes(scale);
+        for (auto& b : bboxes) b.classId = rand() % numClasses;
+        std::string params = "Clustered bboxes, " + std::to_string(numClasses) + " classes";
+
+        // 基线：逐类调用 nms()
+        std::vector<std::vector<BoundingBox>> groups(numClasses), work;
+        for (const auto& b : bboxes) groups[b.classId].push_back(b);
+        bench.run("Per-class nms()", params, scale, [&]() { work = groups; }, [&]() {
+            for (auto& group : work) nms(group, hard.iouThreshold);
+        });
+
+        for (size_t m = 0; m < modes.size(); m++) {
+            bench.run(names[m], params, scale, []() {}, [&]() { nmsMultiClass(bboxes, modes[m]); });
         }
     }
 }
 
-int main() {
-    srand(static_cast<unsigned int>(time(0)));
-    testSortingAlgorithms();
+// 用法：main [--warmup N] [--repeats N] [--seed N] [--counters] [--csv 文件] [--json 文件]
+int main(int argc, char** argv) {
+    Benchmark bench(BenchConfig::fromArgs(argc, argv));
+    testSortingAlgorithms(bench);
+    testNmsAlgorithms(bench);
+    testMultiClassNms(bench);
     return 0;
 }
@@ -2,40 +2,169 @@
 #include <algorithm>
 #include <ctime>
 #include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 typedef int Rank;               // 秩
 #define DEFAULT_CAPACITY 3      // 默认初始容量
 
+enum SortMethod {               // Vector::sort() 可选的排序算法
+    BUBBLE_SORT, SELECTION_SORT, MERGE_SORT, QUICK_SORT, HEAP_SORT,
+    INTRO_SORT,                 // 内省排序：生产环境默认
+    PARALLEL_MERGE_SORT,        // 多线程归并排序（稳定）
+    RADIX_SORT                  // LSD 基数排序：仅限整数与 float/double，其余类型退化为内省排序
+};
+
+/* 竞技场（bump）分配器：按块顺序切分内存，reset() 一次性回收全部对象 */
+class Arena {
+private:
+    struct Block { Block* next; std::size_t size; };
+    Block* _head;               // 当前块（链表头）
+    char* _cur;                 // 当前块内的分配指针
+    char* _end;                 // 当前块末尾
+    std::size_t _blockSize;     // 默认块大小
+
+    void grow(std::size_t need) {                   // 申请新块
+        std::size_t sz = std::max(_blockSize, need + alignof(std::max_align_t));
+        Block* b = static_cast<Block*>(::operator new(sizeof(Block) + sz));
+        b->next = _head; b->size = sz;
+        _head = b;
+        _cur = reinterpret_cast<char*>(b + 1);
+        _end = _cur + sz;
+    }
+
+public:
+    explicit Arena(std::size_t blockSize = 64 << 10)
+        : _head(nullptr), _cur(nullptr), _end(nullptr), _blockSize(blockSize) {}
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+    ~Arena() { release(); }
+
+    void* allocate(std::size_t bytes, std::size_t align) {
+        std::size_t pad = (align - reinterpret_cast<std::size_t>(_cur) % align) % align;
+        if (!_head || bytes + pad > std::size_t(_end - _cur)) {
+            grow(bytes);
+            pad = (align - reinterpret_cast<std::size_t>(_cur) % align) % align;
+        }
+        char* p = _cur + pad;
+        _cur = p + bytes;
+        return p;
+    }
+    void deallocate(void* p, std::size_t bytes) {  // 只回收最近一次分配，其余留待 reset()
+        if (static_cast<char*>(p) + bytes == _cur) _cur = static_cast<char*>(p);
+    }
+    void reset() {                                  // 保留当前块，释放其余块
+        if (!_head) return;
+        Block* b = _head->next;
+        while (b) { Block* next = b->next; ::operator delete(b); b = next; }
+        _head->next = nullptr;
+        _cur = reinterpret_cast<char*>(_head + 1);
+        _end = _cur + _head->size;
+    }
+    void release() {                                // 释放全部块
+        while (_head) { Block* next = _head->next; ::operator delete(_head); _head = next; }
+        _cur = _end = nullptr;
+    }
+};
+
+/* 从指定 Arena 取内存的分配器 */
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+    Arena* arena;
+
+    ArenaAllocator(Arena& a) : arena(&a) {}
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const& other) : arena(other.arena) {}
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, std::size_t n) { arena->deallocate(p, n * sizeof(T)); }
+};
+template <typename T, typename U>
+bool operator==(ArenaAllocator<T> const& a, ArenaAllocator<U> const& b) { return a.arena == b.arena; }
+template <typename T, typename U>
+bool operator!=(ArenaAllocator<T> const& a, ArenaAllocator<U> const& b) { return a.arena != b.arena; }
+
+/* 线程局部内存池：每个线程一个 Arena，请求结束时调用 threadArena().reset() */
+inline Arena& threadArena() {
+    thread_local Arena arena;
+    return arena;
+}
 template <typename T>
+struct PoolAllocator {          // 默认构造即可使用，只能在分配它的线程内使用
+    typedef T value_type;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(PoolAllocator<U> const&) {}
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(threadArena().allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, std::size_t n) { threadArena().deallocate(p, n * sizeof(T)); }
+};
+template <typename T, typename U>
+bool operator==(PoolAllocator<T> const&, PoolAllocator<U> const&) { return true; }
+template <typename T, typename U>
+bool operator!=(PoolAllocator<T> const&, PoolAllocator<U> const&) { return false; }
+
+template <typename T, typename Alloc = std::allocator<T>>
 class Vector {
 private:
+    typedef std::allocator_traits<Alloc> Traits;
+
     Rank _size;                 // 当前元素个数
     int _capacity;              // 当前容量
     T* _elem;                   // 数据区首地址
+    Alloc _alloc;               // 分配器
 
     /* 内部工具函数 */
+    T* allocate(int n) {                            // 只分配原始存储，不构造元素
+        return Traits::allocate(_alloc, n);
+    }
+    void deallocate(T* p, int n) { if (p) Traits::deallocate(_alloc, p, n); }
+    static void destroy(T* p, Rank n) {             // 析构 p[0, n)
+        if (!std::is_trivially_destructible<T>::value)
+            for (Rank i = 0; i < n; ++i) p[i].~T();
+    }
+    static void relocate(T* dst, T* src, Rank n) {  // 将 src[0, n) 搬迁至未初始化的 dst
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            if (n > 0) std::memcpy(static_cast<void*>(dst), src, sizeof(T) * n);
+        } else {
+            for (Rank i = 0; i < n; ++i) {
+                ::new (dst + i) T(std::move_if_noexcept(src[i]));
+                src[i].~T();
+            }
+        }
+    }
+    void reallocate(int c) {                        // 换用容量为 c 的新数据区
+        T* old = _elem;
+        _elem = allocate(c);
+        relocate(_elem, old, _size);
+        deallocate(old, _capacity);
+        _capacity = c;
+    }
     void copyFrom(T const* A, Rank lo, Rank hi) {   // 复制数组区间 A[lo, hi)
         _size = 0;
-        _capacity = 2 * (hi - lo);
-        _elem = new T[_capacity];
-        while (lo < hi) _elem[_size++] = A[lo++];
+        _capacity = std::max(2 * (hi - lo), DEFAULT_CAPACITY);
+        _elem = allocate(_capacity);
+        while (lo < hi) { ::new (_elem + _size) T(A[lo++]); ++_size; }
     }
     void expand() {             // 扩容
         if (_size < _capacity) return;
-        _capacity = std::max(_capacity, DEFAULT_CAPACITY) << 1;
-        T* old = _elem;
-        _elem = new T[_capacity];
-        for (Rank i = 0; i < _size; ++i) _elem[i] = old[i];
-        delete [] old;
+        reallocate(std::max(_capacity, DEFAULT_CAPACITY) << 1);
     }
     void shrink() {             // 装填因子过小时缩容
         if (_capacity < DEFAULT_CAPACITY << 1) return;
         if (_size << 2 > _capacity) return;         // 25% 以上不缩
-        _capacity >>= 1;
-        T* old = _elem;
-        _elem = new T[_capacity];
-        for (Rank i = 0; i < _size; ++i) _elem[i] = old[i];
-        delete [] old;
+        reallocate(_capacity >> 1);
     }
 
     /* 排序相关内部实现 */
@@ -63,34 +192,40 @@ private:
             std::swap(_elem[mx], _elem[hi]);
         }
     }
-    void merge(Rank lo, Rank mi, Rank hi) {         // 归并
+    void merge(Rank lo, Rank mi, Rank hi, T* B) {   // 归并，B 为未初始化的暂存区
         Rank lb = mi - lo, lc = hi - mi;
-        T* B = new T[lb];
-        for (Rank i = 0; i < lb; B[i] = _elem[lo + i], ++i);
+        for (Rank i = 0; i < lb; ::new (B + i) T(std::move(_elem[lo + i])), ++i);
         Rank i = 0, j = 0, k = lo;
-        while (j < lc) {
-            if (i < lb && B[i] <= _elem[mi + j]) _elem[k++] = B[i++];
-            else                                  _elem[k++] = _elem[mi + j++];
+        while (i < lb && j < lc) {                  // 右段剩余元素已在原位，无需自移动
+            if (B[i] <= _elem[mi + j]) _elem[k++] = std::move(B[i++]);
+            else                                  _elem[k++] = std::move(_elem[mi + j++]);
         }
-        while (i < lb) _elem[k++] = B[i++];
-        delete [] B;
+        while (i < lb) _elem[k++] = std::move(B[i++]);
+        destroy(B, lb);
     }
-    void mergeSort(Rank lo, Rank hi) {              // 归并排序
+    void mergeSort(Rank lo, Rank hi, T* B) {
         if (hi - lo < 2) return;
         Rank mi = (lo + hi) >> 1;
-        mergeSort(lo, mi);
-        mergeSort(mi, hi);
-        merge(lo, mi, hi);
+        mergeSort(lo, mi, B);
+        mergeSort(mi, hi, B);
+        merge(lo, mi, hi, B);
+    }
+    void mergeSort(Rank lo, Rank hi) {              // 归并排序：暂存区从分配器一次取得
+        if (hi - lo < 2) return;
+        Rank n = (hi - lo + 1) >> 1;
+        T* B = allocate(n);
+        mergeSort(lo, hi, B);
+        deallocate(B, n);
     }
     Rank partition(Rank lo, Rank hi) {              // 快速排序轴点构造
-        T pivot = _elem[lo];
+        T pivot = std::move(_elem[lo]);
         while (lo < hi) {
             while (lo < hi && pivot <= _elem[hi]) --hi;
-            _elem[lo] = _elem[hi];
+            _elem[lo] = std::move(_elem[hi]);
             while (lo < hi && _elem[lo] <= pivot) ++lo;
-            _elem[hi] = _elem[lo];
+            _elem[hi] = std::move(_elem[lo]);
         }
-        _elem[lo] = pivot;
+        _elem[lo] = std::move(pivot);
         return lo;
     }
     void quickSort(Rank lo, Rank hi) {              // 快速排序
@@ -104,16 +239,227 @@ private:
         std::sort_heap(_elem + lo, _elem + hi);
     }
 
+    /* 内省排序（pdqsort 思路）：
+     * 小区间插入排序；三数取中/九数取中选轴点；轴点与左邻相等时三路划分，
+     * 一次性归位全部重复元素；递归过深时退化为堆排序，保证 O(n log n)。 */
+    static const Rank INSERTION_CUTOFF = 24;        // 插入排序阈值
+    static const Rank NINTHER_CUTOFF = 128;         // 九数取中阈值
+    void insertionSort(Rank lo, Rank hi) {          // 插入排序
+        for (Rank i = lo + 1; i < hi; ++i) {
+            if (!(_elem[i] < _elem[i - 1])) continue;
+            T e = std::move(_elem[i]);
+            Rank j = i;
+            do { _elem[j] = std::move(_elem[j - 1]); } while (--j > lo && e < _elem[j - 1]);
+            _elem[j] = std::move(e);
+        }
+    }
+    void sort3(Rank a, Rank b, Rank c) {            // 使 _elem[a] <= _elem[b] <= _elem[c]
+        if (_elem[b] < _elem[a]) std::swap(_elem[a], _elem[b]);
+        if (_elem[c] < _elem[b]) std::swap(_elem[b], _elem[c]);
+        if (_elem[b] < _elem[a]) std::swap(_elem[a], _elem[b]);
+    }
+    void choosePivot(Rank lo, Rank hi) {            // 选出轴点并置于 _elem[lo]
+        Rank n = hi - lo, mi = lo + n / 2;
+        if (n > NINTHER_CUTOFF) {                   // Tukey 九数取中
+            sort3(lo, mi, hi - 1);
+            sort3(lo + 1, mi - 1, hi - 2);
+            sort3(lo + 2, mi + 1, hi - 3);
+            sort3(mi - 1, mi, mi + 1);
+            std::swap(_elem[lo], _elem[mi]);
+        } else {
+            sort3(mi, lo, hi - 1);
+        }
+    }
+    Rank partitionRight(Rank lo, Rank hi) {         // 以 _elem[lo] 为轴：小于轴点者居左，返回轴点秩
+        T const& pivot = _elem[lo];
+        Rank i = lo + 1, j = hi - 1;
+        if constexpr (std::is_arithmetic<T>::value) {   // 无分支 Lomuto 划分，免去分支预测失败
+            T pv = pivot;
+            for (Rank k = lo + 1; k < hi; ++k) {
+                T x = _elem[k];
+                _elem[k] = _elem[i];
+                _elem[i] = x;
+                i += (x < pv);
+            }
+            j = i - 1;
+        } else {
+            while (true) {
+                while (i <= j && _elem[i] < pivot) ++i;
+                while (i <= j && !(_elem[j] < pivot)) --j;
+                if (i >= j) break;
+                std::swap(_elem[i++], _elem[j--]);
+            }
+        }
+        std::swap(_elem[lo], _elem[j]);
+        return j;
+    }
+    Rank partitionLeft(Rank lo, Rank hi) {          // 不大于轴点者居左，返回最后一个此类元素的秩
+        T const& pivot = _elem[lo];
+        Rank i = lo + 1, j = hi - 1;
+        while (true) {
+            while (i <= j && !(pivot < _elem[i])) ++i;
+            while (i <= j && pivot < _elem[j]) --j;
+            if (i >= j) break;
+            std::swap(_elem[i++], _elem[j--]);
+        }
+        std::swap(_elem[lo], _elem[j]);
+        return j;
+    }
+    void introSort(Rank lo, Rank hi, int depth, bool leftmost) {
+        while (hi - lo > INSERTION_CUTOFF) {
+            choosePivot(lo, hi);
+            if (!leftmost && !(_elem[lo - 1] < _elem[lo])) {
+                // 轴点等于左邻（左邻不大于区间内任何元素），故不大于轴点者皆与之相等，已就位
+                lo = partitionLeft(lo, hi) + 1;
+                continue;
+            }
+            if (depth-- == 0) { heapSort(lo, hi); return; }
+            Rank mi = partitionRight(lo, hi);
+            if (mi - lo < hi - mi - 1) {            // 递归较短一侧，循环处理较长一侧
+                introSort(lo, mi, depth, leftmost);
+                lo = mi + 1; leftmost = false;
+            } else {
+                introSort(mi + 1, hi, depth, false);
+                hi = mi;
+            }
+        }
+        insertionSort(lo, hi);
+    }
+    void introSort(Rank lo, Rank hi) {
+        int depth = 0;
+        for (Rank n = hi - lo; n > 1; n >>= 1) depth += 2;  // 深度上限 2 log n
+        introSort(lo, hi, depth, true);
+    }
+
+    /* 并行归并排序：自顶向下分治，上层子任务分派给新线程；
+     * 全程只用一块与区间等长的乒乓缓冲区，合并时按协同秩（co-rank）切分输出区间，
+     * 各线程独立归并互不重叠的片段。结果与顺序稳定排序逐元素相同。 */
+    static const Rank PARALLEL_CUTOFF = 1 << 14;    // 小于此规模不再拆分
+    static Rank corank(Rank i, T const* A, Rank m, T const* B, Rank n) {
+        // 求 j + k = i，使稳定归并的前 i 个输出恰为 A[0, j) 与 B[0, k)
+        Rank j = std::min(i, m), k = i - j;
+        Rank jLow = std::max(0, i - n), kLow = std::max(0, i - m);
+        while (true) {
+            if (j > 0 && k < n && B[k] < A[j - 1]) {
+                Rank d = (j - jLow + 1) >> 1;
+                kLow = k; j -= d; k += d;
+            } else if (k > 0 && j < m && !(B[k - 1] < A[j])) {
+                Rank d = (k - kLow + 1) >> 1;
+                jLow = j; j += d; k -= d;
+            } else {
+                return j;
+            }
+        }
+    }
+    static void mergeRange(T* A, Rank m, T* B, Rank n, T* C) {  // 稳定归并 A、B 至 C
+        Rank i = 0, j = 0, k = 0;
+        while (i < m && j < n) C[k++] = (B[j] < A[i]) ? std::move(B[j++]) : std::move(A[i++]);
+        while (i < m) C[k++] = std::move(A[i++]);
+        while (j < n) C[k++] = std::move(B[j++]);
+    }
+    static void parallelMerge(T* A, Rank m, T* B, Rank n, T* C, unsigned threads) {
+        if (threads < 2 || m + n < PARALLEL_CUTOFF) { mergeRange(A, m, B, n, C); return; }
+        std::vector<std::thread> workers;
+        Rank total = m + n, j0 = 0;
+        for (unsigned t = 0; t < threads; ++t) {
+            Rank i1 = (t + 1 == threads) ? total : Rank((long long)total * (t + 1) / threads);
+            Rank j1 = corank(i1, A, m, B, n);
+            Rank i0 = Rank((long long)total * t / threads), k0 = i0 - j0, k1 = i1 - j1;
+            if (t + 1 == threads) mergeRange(A + j0, j1 - j0, B + k0, k1 - k0, C + i0);
+            else workers.emplace_back(mergeRange, A + j0, j1 - j0, B + k0, k1 - k0, C + i0);
+            j0 = j1;
+        }
+        for (auto& w : workers) w.join();
+    }
+    static void leafSort(T* A, T* B, Rank n, bool toB) {    // 顺序自底向上归并，A、B 轮流作暂存
+        const Rank RUN = 32;
+        for (Rank lo = 0; lo < n; lo += RUN)        // 先以插入排序生成有序小段
+            for (Rank i = lo + 1; i < std::min(lo + RUN, n); ++i)
+                for (Rank j = i; j > lo && A[j] < A[j - 1]; --j) std::swap(A[j], A[j - 1]);
+        T* src = A; T* dst = B;
+        for (Rank w = RUN; w < n; w <<= 1, std::swap(src, dst))
+            for (Rank lo = 0; lo < n; lo += w << 1) {
+                Rank m = std::min(w, n - lo), r = std::min(w, n - lo - m);
+                mergeRange(src + lo, m, src + lo + m, r, dst + lo);
+            }
+        if ((src == B) != toB) std::move(src, src + n, toB ? B : A);
+    }
+    static void parallelSort(T* A, T* B, Rank n, bool toB, unsigned threads) {
+        // 排序 A[0, n)，toB 为真时结果置于 B，否则置于 A；两者互为暂存区
+        if (threads < 2 || n < PARALLEL_CUTOFF) { leafSort(A, B, n, toB); return; }
+        Rank mi = n >> 1;
+        unsigned lt = threads >> 1;
+        std::thread left(parallelSort, A, B, mi, !toB, lt);
+        parallelSort(A + mi, B + mi, n - mi, !toB, threads - lt);
+        left.join();
+        T* src = toB ? A : B;
+        parallelMerge(src, mi, src + mi, n - mi, toB ? B : A, threads);
+    }
+
+    /* LSD 基数排序：把元素映射为同宽无符号键（有符号数翻转符号位，浮点数负数全翻转、
+     * 非负数翻转符号位），每字节一趟计数分配；所有元素该字节相同的一趟直接跳过。 */
+    typedef typename std::conditional<sizeof(T) == 1, std::uint8_t,
+            typename std::conditional<sizeof(T) == 2, std::uint16_t,
+            typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type>::type>::type RadixKey;
+    static const bool RADIX_SORTABLE = std::is_integral<T>::value
+        || std::is_same<T, float>::value || std::is_same<T, double>::value;
+    static RadixKey radixKey(T const& x) {          // 保序映射：a < b 当且仅当 key(a) < key(b)
+        RadixKey u;
+        std::memcpy(&u, &x, sizeof(T));
+        const RadixKey top = RadixKey(RadixKey(1) << (8 * sizeof(T) - 1));
+        if constexpr (std::is_floating_point<T>::value) return (u & top) ? RadixKey(~u) : RadixKey(u | top);
+        else if constexpr (std::is_signed<T>::value) return RadixKey(u ^ top);
+        else return u;
+    }
+    void radixSort(Rank lo, Rank hi) {
+        if constexpr (!RADIX_SORTABLE) {
+            introSort(lo, hi);
+        } else {
+            Rank n = hi - lo;
+            if (n < 2) return;
+            const int D = sizeof(T);
+            Rank count[D][256] = {};
+            for (Rank i = lo; i < hi; ++i) {        // 一遍扫描统计所有字节的直方图
+                RadixKey k = radixKey(_elem[i]);
+                for (int d = 0; d < D; ++d) ++count[d][(k >> (8 * d)) & 0xFF];
+            }
+            T* B = allocate(n);
+            T* src = _elem + lo;
+            T* dst = B;
+            RadixKey first = radixKey(src[0]);
+            for (int d = 0; d < D; ++d) {
+                if (count[d][(first >> (8 * d)) & 0xFF] == n) continue;   // 该字节全部相同
+                Rank offset[256], sum = 0;
+                for (int b = 0; b < 256; ++b) { offset[b] = sum; sum += count[d][b]; }
+                for (Rank i = 0; i < n; ++i) dst[offset[(radixKey(src[i]) >> (8 * d)) & 0xFF]++] = src[i];
+                std::swap(src, dst);
+            }
+            if (src != _elem + lo) std::memcpy(_elem + lo, src, sizeof(T) * n);
+            deallocate(B, n);
+        }
+    }
+
 public:
     /* 构造与析构 */
-    Vector(int c = DEFAULT_CAPACITY, Rank s = 0, T v = T())
-        : _capacity(c), _size(0) {
-        _elem = new T[_capacity];
-        while (_size < s) _elem[_size++] = v;
+    Vector(int c = DEFAULT_CAPACITY, Rank s = 0, T v = T(), Alloc const& a = Alloc())
+        : _size(0), _capacity(std::max(c, s)), _alloc(a) {
+        _elem = allocate(_capacity);
+        while (_size < s) { ::new (_elem + _size) T(v); ++_size; }
+    }
+    explicit Vector(Alloc const& a) : Vector(DEFAULT_CAPACITY, 0, T(), a) {}
+    Vector(T const* A, Rank lo, Rank hi, Alloc const& a = Alloc())
+        : _alloc(a) { copyFrom(A, lo, hi); }
+    Vector(Vector const& V)
+        : _alloc(Traits::select_on_container_copy_construction(V._alloc)) {
+        copyFrom(V._elem, 0, V._size);
     }
-    Vector(T const* A, Rank lo, Rank hi) { copyFrom(A, lo, hi); }
-    Vector(Vector<T> const& V) { copyFrom(V._elem, 0, V._size); }
-    ~Vector() { delete [] _elem; }
+    Vector(Vector&& V) noexcept                     // 移动构造：直接接管数据区
+        : _size(V._size), _capacity(V._capacity), _elem(V._elem), _alloc(std::move(V._alloc)) {
+        V._size = V._capacity = 0; V._elem = nullptr;
+    }
+    ~Vector() { destroy(_elem, _size); deallocate(_elem, _capacity); }
+
+    Alloc get_allocator() const { return _alloc; }
 
     /* 只读接口 */
     Rank size() const { return _size; }
@@ -140,35 +486,97 @@ public:
 
     /* 可写接口 */
     T& operator[](Rank r) const { return _elem[r]; }
-    Vector<T>& operator=(Vector<T> const& V) {
+    Vector& operator=(Vector const& V) {
         if (this != &V) {
-            delete [] _elem;
+            destroy(_elem, _size); deallocate(_elem, _capacity);
+            if (Traits::propagate_on_container_copy_assignment::value) _alloc = V._alloc;
             copyFrom(V._elem, 0, V._size);
         }
         return *this;
     }
+    Vector& operator=(Vector&& V) {
+        if (this == &V) return *this;
+        if (!Traits::propagate_on_container_move_assignment::value && !(_alloc == V._alloc)) {
+            destroy(_elem, _size);                  // 分配器不同，只能逐个移动元素
+            if (_capacity < V._size) {
+                deallocate(_elem, _capacity);
+                _capacity = V._size;
+                _elem = allocate(_capacity);
+            }
+            for (_size = 0; _size < V._size; ++_size) ::new (_elem + _size) T(std::move(V._elem[_size]));
+            return *this;
+        }
+        destroy(_elem, _size); deallocate(_elem, _capacity);
+        if (Traits::propagate_on_container_move_assignment::value) _alloc = std::move(V._alloc);
+        _size = V._size; _capacity = V._capacity; _elem = V._elem;
+        V._size = V._capacity = 0; V._elem = nullptr;
+        return *this;
+    }
     T remove(Rank r) {                              // 删除秩为 r 的元素
-        T e = _elem[r];
+        T e = std::move(_elem[r]);
         remove(r, r + 1);
         return e;
     }
     int remove(Rank lo, Rank hi) {                  // 删除区间 [lo, hi)
         if (lo == hi) return 0;
-        while (hi < _size) _elem[lo++] = _elem[hi++];
+        while (hi < _size) _elem[lo++] = std::move(_elem[hi++]);
+        destroy(_elem + lo, _size - lo);            // 析构搬空的尾部
         _size = lo;
         shrink();
         return hi - lo;
     }
-    Rank insert(Rank r, T const& e) {               // 插入元素
+    template <typename... Args>
+    Rank emplace(Rank r, Args&&... args) {          // 在秩 r 处就地构造元素
+        if (r == _size) { emplace_back(std::forward<Args>(args)...); return r; }
+        T e(std::forward<Args>(args)...);           // 参数可能引用自身元素，先行构造
         expand();
-        for (Rank i = _size; i > r; --i) _elem[i] = _elem[i - 1];
-        _elem[r] = e; ++_size;
+        ::new (_elem + _size) T(std::move(_elem[_size - 1]));
+        for (Rank i = _size - 1; i > r; --i) _elem[i] = std::move(_elem[i - 1]);
+        _elem[r] = std::move(e); ++_size;
         return r;
     }
-    Rank insert(T const& e) { return insert(_size, e); }
+    template <typename... Args>
+    Rank emplace_back(Args&&... args) {             // 在末尾就地构造元素
+        if (_size < _capacity) {
+            ::new (_elem + _size) T(std::forward<Args>(args)...);
+            return _size++;
+        }
+        int c = std::max(_capacity, DEFAULT_CAPACITY) << 1;
+        T* elem = allocate(c);                      // 先在新数据区构造，再搬迁旧元素
+        ::new (elem + _size) T(std::forward<Args>(args)...);
+        relocate(elem, _elem, _size);
+        deallocate(_elem, _capacity);
+        _elem = elem; _capacity = c;
+        return _size++;
+    }
+    Rank insert(Rank r, T const& e) { return emplace(r, e); }  // 插入元素
+    Rank insert(Rank r, T&& e) { return emplace(r, std::move(e)); }
+    Rank insert(T const& e) { return emplace_back(e); }
+    Rank insert(T&& e) { return emplace_back(std::move(e)); }
 
-    void sort(Rank lo, Rank hi) { mergeSort(lo, hi); }  // 可随意切换排序算法
-    void sort() { sort(0, _size); }
+    void sort(Rank lo, Rank hi, SortMethod m = INTRO_SORT) {   // 可随意切换排序算法
+        switch (m) {
+        case BUBBLE_SORT:    bubbleSort(lo, hi); break;
+        case SELECTION_SORT: selectionSort(lo, hi); break;
+        case MERGE_SORT:     mergeSort(lo, hi); break;
+        case QUICK_SORT:     quickSort(lo, hi); break;
+        case HEAP_SORT:      heapSort(lo, hi); break;
+        case PARALLEL_MERGE_SORT: parallelMergeSort(lo, hi); break;
+        case RADIX_SORT:     radixSort(lo, hi); break;
+        default:             introSort(lo, hi); break;
+        }
+    }
+    void sort(SortMethod m = INTRO_SORT) { sort(0, _size, m); }
+    void parallelMergeSort(Rank lo, Rank hi, unsigned threads = 0) {  // threads 为 0 时取硬件线程数
+        if (hi - lo < 2) return;
+        if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+        Rank n = hi - lo;
+        T* B = allocate(n);                         // 唯一的乒乓缓冲区
+        for (Rank i = 0; i < n; ++i) ::new (B + i) T(std::move(_elem[lo + i]));
+        parallelSort(B, _elem + lo, n, true, threads);
+        destroy(B, n);
+        deallocate(B, n);
+    }
     void unsort(Rank lo, Rank hi) {                 // 置乱
         T* A = _elem + lo;
         for (Rank i = hi - lo; i > 0; --i)
@@ -185,8 +593,11 @@ public:
     }
     int uniquify() {                                // 有序去重
         Rank i = 0, j = 0;
+        if (_size < 2) return 0;
         while (++j < _size)
-            if (_elem[i] != _elem[j]) _elem[++i] = _elem[j];
+            if (_elem[i] != _elem[j])
+                if (++i != j) _elem[i] = std::move(_elem[j]);  // 避免自移动赋值
+        destroy(_elem + i + 1, _size - i - 1);
         _size = i + 1;
         shrink();
         return j - i;